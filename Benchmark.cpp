@@ -0,0 +1,284 @@
+#include "Benchmark.hpp"
+#include "UI.hpp"
+#include <furi_hal_cortex.h>
+#include <stm32wbxx.h>
+
+static constexpr const char* benchmarkTestNames[] = { "seq_write", "seq_read", "rand_write", "rand_read", "open_close", "sync" };
+
+static uint32_t millisecondsSince(const uint32_t tick) noexcept
+{
+    return static_cast<uint32_t>(static_cast<uint64_t>(furi_get_tick() - tick) * 1000 / furi_kernel_get_tick_frequency());
+}
+
+// The firmware enables the cycle counter at boot. It wraps after about a minute at 64 MHz, far longer than any single
+// operation should take.
+static uint32_t cycles() noexcept
+{
+    return DWT->CYCCNT;
+}
+
+static uint32_t microsecondsSince(const uint32_t start) noexcept
+{
+    return (cycles() - start) / furi_hal_cortex_instructions_per_microsecond();
+}
+
+// =====================================================================================================================
+// ================================================= Storage benchmark =================================================
+// =====================================================================================================================
+
+bool UFZ::StorageBenchmark::run(const Filesystem& filesystem, const Settings& settings) noexcept
+{
+    current = settings;
+    count = 0;
+    totalSpace = 0;
+    freeSpace = 0;
+    bSucceeded = false;
+
+    // Fixed seed, so every run and every card sees the same access pattern
+    random = 0x2545F491;
+
+    const FS_Error error = filesystem.mkdir(current.directory);
+    if ((error != FSE_OK && error != FSE_EXIST) || filesystem.filesystemInfo(current.directory, &totalSpace, &freeSpace) != FSE_OK ||
+        freeSpace < current.fileSize || current.fileSize < largestBlockSize)
+        return false;
+
+    PathBuffer<128> path(current.directory);
+    if (!path.join("benchmark.bin"))
+        return false;
+
+    buffer = static_cast<uint8_t*>(malloc(largestBlockSize));
+    if (buffer == nullptr)
+        return false;
+    for (uint32_t i = 0; i < largestBlockSize; i++)
+        buffer[i] = static_cast<uint8_t>(i * 31 + 7);
+
+    for (const uint32_t blockSize : blockSizes)
+    {
+        sequentialWrite(filesystem, path, blockSize);
+        sequentialRead(filesystem, path, blockSize);
+        randomAccess(filesystem, path, blockSize, true);
+        randomAccess(filesystem, path, blockSize, false);
+    }
+    openClose(filesystem, path);
+    syncLatency(filesystem, path);
+
+    FREE_GUARD(::free, buffer);
+    UNUSED(filesystem.remove(path));
+
+    bSucceeded = true;
+    for (size_t i = 0; i < count; i++)
+        if (results[i].bError)
+            bSucceeded = false;
+    return bSucceeded;
+}
+
+bool UFZ::StorageBenchmark::runInBackground(Application& app, const std::function<void()>& onDone, const uint32_t loadingScene, const Settings& settings, const uint32_t loadingDelay) noexcept
+{
+    const Filesystem* filesystem = &app.getFilesystem();
+    return app.runInBackground([this, filesystem, settings]() -> void
+    {
+        UNUSED(run(*filesystem, settings));
+    }, onDone, loadingScene, loadingDelay);
+}
+
+const UFZ::StorageBenchmark::Result& UFZ::StorageBenchmark::get(const size_t i) const noexcept
+{
+    return results[i];
+}
+
+size_t UFZ::StorageBenchmark::size() const noexcept
+{
+    return count;
+}
+
+bool UFZ::StorageBenchmark::succeeded() const noexcept
+{
+    return bSucceeded;
+}
+
+const char* UFZ::StorageBenchmark::getTestName(const Test test) noexcept
+{
+    return benchmarkTestNames[static_cast<size_t>(test)];
+}
+
+uint64_t UFZ::StorageBenchmark::getRate(const Result& result) noexcept
+{
+    return result.milliseconds > 0 ? result.bytes * 1000 / result.milliseconds : 0;
+}
+
+uint32_t UFZ::StorageBenchmark::getOperationRate(const Result& result) noexcept
+{
+    return result.milliseconds > 0 ? static_cast<uint32_t>(static_cast<uint64_t>(result.operations) * 1000 / result.milliseconds) : 0;
+}
+
+void UFZ::StorageBenchmark::render(const TextBox& textBox, FuriString* out) const noexcept
+{
+    furi_string_cat_printf(out, "Free %lu of %lu MiB\n", static_cast<unsigned long>(freeSpace >> 20), static_cast<unsigned long>(totalSpace >> 20));
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto& a = results[i];
+        if (a.bError)
+            furi_string_cat_printf(out, "%s %lu failed\n", getTestName(a.test), static_cast<unsigned long>(a.blockSize));
+        else if (a.test == Test::OpenClose || a.test == Test::Sync)
+            furi_string_cat_printf(out, "%s %lu/s max %luus\n", getTestName(a.test), static_cast<unsigned long>(getOperationRate(a)),
+                                   static_cast<unsigned long>(a.longestMicroseconds));
+        else
+            furi_string_cat_printf(out, "%s %lu %llu KiB/s\n", getTestName(a.test), static_cast<unsigned long>(a.blockSize),
+                                   static_cast<unsigned long long>(getRate(a) >> 10));
+    }
+    UNUSED(textBox.setText(furi_string_get_cstr(out)));
+}
+
+bool UFZ::StorageBenchmark::dump(const Filesystem& filesystem, const char* path) const noexcept
+{
+    File file(filesystem, path, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    if (!file.isOpen())
+        return false;
+
+    char line[128];
+    int length = snprintf(line, sizeof(line), "# total_bytes %llu free_bytes %llu file_size %lu\n", static_cast<unsigned long long>(totalSpace),
+                          static_cast<unsigned long long>(freeSpace), static_cast<unsigned long>(current.fileSize));
+    bool bResult = length > 0 && file.write(line, length) == static_cast<size_t>(length);
+
+    static constexpr char header[] = "test,block_size,operations,bytes,total_ms,bytes_per_s,ops_per_s,max_us,error\n";
+    bResult = bResult && file.write(header, sizeof(header) - 1) == sizeof(header) - 1;
+
+    for (size_t i = 0; i < count && bResult; i++)
+    {
+        const auto& a = results[i];
+        length = snprintf(line, sizeof(line), "%s,%lu,%lu,%llu,%lu,%llu,%lu,%lu,%u\n", getTestName(a.test), static_cast<unsigned long>(a.blockSize),
+                          static_cast<unsigned long>(a.operations), static_cast<unsigned long long>(a.bytes), static_cast<unsigned long>(a.milliseconds),
+                          static_cast<unsigned long long>(getRate(a)), static_cast<unsigned long>(getOperationRate(a)), static_cast<unsigned long>(a.longestMicroseconds), a.bError);
+        bResult = length > 0 && file.write(line, length) == static_cast<size_t>(length);
+    }
+    return bResult;
+}
+
+UFZ::StorageBenchmark::Result& UFZ::StorageBenchmark::add(const Test test, const uint32_t blockSize) noexcept
+{
+    Result& result = results[count++];
+    result = { test, blockSize, 0, 0, 0, 0, false };
+    return result;
+}
+
+// xorshift32, picks a block index below blocks
+uint32_t UFZ::StorageBenchmark::nextBlock(const uint32_t blocks) noexcept
+{
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return random % blocks;
+}
+
+void UFZ::StorageBenchmark::sequentialWrite(const Filesystem& filesystem, const char* path, const uint32_t blockSize) noexcept
+{
+    Result& result = add(Test::SequentialWrite, blockSize);
+    const uint32_t start = furi_get_tick();
+
+    // Closing flushes the card's cache, it is part of what a recording pays
+    {
+        File file(filesystem, path, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+        result.bError = !file.isOpen();
+        for (uint32_t written = 0; written < current.fileSize && !result.bError; written += blockSize)
+        {
+            result.bError = file.write(buffer, blockSize) != blockSize;
+            if (result.bError)
+                break;
+            result.bytes += blockSize;
+            result.operations++;
+        }
+    }
+    result.milliseconds = millisecondsSince(start);
+}
+
+void UFZ::StorageBenchmark::sequentialRead(const Filesystem& filesystem, const char* path, const uint32_t blockSize) noexcept
+{
+    Result& result = add(Test::SequentialRead, blockSize);
+    const uint32_t start = furi_get_tick();
+    {
+        File file(filesystem, path, FSAM_READ, FSOM_OPEN_EXISTING);
+        result.bError = !file.isOpen();
+        while (!result.bError && result.bytes < current.fileSize)
+        {
+            const size_t bytes = file.read(buffer, blockSize);
+            result.bError = bytes == 0;
+            if (result.bError)
+                break;
+            result.bytes += bytes;
+            result.operations++;
+        }
+    }
+    result.milliseconds = millisecondsSince(start);
+}
+
+void UFZ::StorageBenchmark::randomAccess(const Filesystem& filesystem, const char* path, const uint32_t blockSize, const bool bWrite) noexcept
+{
+    Result& result = add(bWrite ? Test::RandomWrite : Test::RandomRead, blockSize);
+    const uint32_t blocks = current.fileSize / blockSize;
+    const uint32_t start = furi_get_tick();
+    {
+        File file(filesystem, path, bWrite ? FSAM_READ_WRITE : FSAM_READ, FSOM_OPEN_EXISTING);
+        result.bError = !file.isOpen();
+        for (uint32_t i = 0; i < current.randomOperations && !result.bError; i++)
+        {
+            const uint32_t before = cycles();
+            result.bError = !file.seek(nextBlock(blocks) * blockSize, true) ||
+                            (bWrite ? file.write(buffer, blockSize) : file.read(buffer, blockSize)) != blockSize;
+            if (result.bError)
+                break;
+
+            const uint32_t elapsed = microsecondsSince(before);
+            if (elapsed > result.longestMicroseconds)
+                result.longestMicroseconds = elapsed;
+            result.bytes += blockSize;
+            result.operations++;
+        }
+    }
+    result.milliseconds = millisecondsSince(start);
+}
+
+void UFZ::StorageBenchmark::openClose(const Filesystem& filesystem, const char* path) noexcept
+{
+    Result& result = add(Test::OpenClose, 0);
+    const uint32_t start = furi_get_tick();
+    for (uint32_t i = 0; i < current.openCloseOperations && !result.bError; i++)
+    {
+        const uint32_t before = cycles();
+        {
+            const File file(filesystem, path, FSAM_READ, FSOM_OPEN_EXISTING);
+            result.bError = !file.isOpen();
+        }
+        if (result.bError)
+            break;
+
+        const uint32_t elapsed = microsecondsSince(before);
+        if (elapsed > result.longestMicroseconds)
+            result.longestMicroseconds = elapsed;
+        result.operations++;
+    }
+    result.milliseconds = millisecondsSince(start);
+}
+
+// Each operation appends one small block and syncs it, the pattern of a log that must survive power loss
+void UFZ::StorageBenchmark::syncLatency(const Filesystem& filesystem, const char* path) noexcept
+{
+    Result& result = add(Test::Sync, blockSizes[0]);
+    File file(filesystem, path, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    result.bError = !file.isOpen();
+
+    const uint32_t start = furi_get_tick();
+    for (uint32_t i = 0; i < current.syncOperations && !result.bError; i++)
+    {
+        const uint32_t before = cycles();
+        result.bError = file.write(buffer, blockSizes[0]) != blockSizes[0] || !file.sync();
+        if (result.bError)
+            break;
+
+        const uint32_t elapsed = microsecondsSince(before);
+        if (elapsed > result.longestMicroseconds)
+            result.longestMicroseconds = elapsed;
+        result.bytes += blockSizes[0];
+        result.operations++;
+    }
+    result.milliseconds = millisecondsSince(start);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "Filesystem.hpp"
+
+namespace UFZ
+{
+    class TextBox;
+
+    // Outside StorageBenchmark so it can be a default argument of its functions
+    struct StorageBenchmarkSettings
+    {
+        // Created if missing, the test file inside it is removed afterwards. Must outlive the run.
+        const char* directory = STORAGE_EXT_PATH_PREFIX "/.ufz_benchmark";
+        uint32_t fileSize = 1024 * 1024;
+        uint32_t randomOperations = 128;
+        uint32_t openCloseOperations = 64;
+        uint32_t syncOperations = 32;
+    };
+
+    // Qualifies a storage card through the same File code path applications use: sequential and random read and write
+    // throughput at several block sizes, the open/close rate and sync() latency. Run it with runInBackground while the
+    // loading scene shows a Loading widget, then show the results with render() in a TextBox and save them with dump().
+    //
+    // Only File, Filesystem, the furi tick and the cycle counter are used, Tools/Host runs the same tests on the host's
+    // disk through a storage stand-in for comparison. Whole tests are timed with furi_get_tick(), single operations with
+    // the DWT cycle counter, so their latency is exact to the microsecond. An operation that fails ends its test and is
+    // not counted.
+    class StorageBenchmark
+    {
+    public:
+        static constexpr uint32_t blockSizes[] = { 512, 4096, 16384 };
+        static constexpr uint32_t largestBlockSize = blockSizes[std::size(blockSizes) - 1];
+
+        // Four tests per block size, then open/close and sync
+        static constexpr size_t maxResults = std::size(blockSizes) * 4 + 2;
+
+        enum class Test : uint8_t
+        {
+            SequentialWrite,
+            SequentialRead,
+            RandomWrite,
+            RandomRead,
+            OpenClose,
+            Sync
+        };
+
+        using Settings = StorageBenchmarkSettings;
+
+        struct Result
+        {
+            Test test;
+            uint32_t blockSize;
+            uint32_t operations;
+            uint64_t bytes;
+
+            // Whole test in milliseconds and slowest single operation in microseconds, the latter is only measured
+            // for the random, open/close and sync tests
+            uint32_t milliseconds;
+            uint32_t longestMicroseconds;
+            bool bError;
+        };
+
+        StorageBenchmark() = default;
+
+        // Runs every test on the calling thread, which should not be the GUI thread. Returns false if the card could
+        // not be prepared, did not have room for the test file or any operation failed.
+        bool run(const Filesystem& filesystem, const Settings& settings = {}) noexcept;
+
+        // Runs on app's BackgroundWorker, see Application::runInBackground. Returns false if the worker is busy.
+        bool runInBackground(Application& app, const std::function<void()>& onDone, uint32_t loadingScene, const Settings& settings = {}, uint32_t loadingDelay = 0) noexcept;
+
+        [[nodiscard]] const Result& get(size_t i) const noexcept;
+        [[nodiscard]] size_t size() const noexcept;
+
+        // False if the last run failed
+        [[nodiscard]] bool succeeded() const noexcept;
+
+        [[nodiscard]] static const char* getTestName(Test test) noexcept;
+
+        // Bytes or operations per second, 0 if the test took less than a millisecond
+        [[nodiscard]] static uint64_t getRate(const Result& result) noexcept;
+        [[nodiscard]] static uint32_t getOperationRate(const Result& result) noexcept;
+
+        // Appends one line per result to out and shows it in textBox. out must outlive the text box's use of it.
+        void render(const TextBox& textBox, FuriString* out) const noexcept;
+
+        // Writes the card's size and the results as CSV, returns false if the file could not be written
+        bool dump(const Filesystem& filesystem, const char* path) const noexcept;
+    private:
+        Settings current{};
+        Result results[maxResults]{};
+        size_t count = 0;
+        uint64_t totalSpace = 0;
+        uint64_t freeSpace = 0;
+        bool bSucceeded = false;
+
+        uint8_t* buffer = nullptr;
+        uint32_t random = 0;
+
+        Result& add(Test test, uint32_t blockSize) noexcept;
+        [[nodiscard]] uint32_t nextBlock(uint32_t blocks) noexcept;
+
+        void sequentialWrite(const Filesystem& filesystem, const char* path, uint32_t blockSize) noexcept;
+        void sequentialRead(const Filesystem& filesystem, const char* path, uint32_t blockSize) noexcept;
+        void randomAccess(const Filesystem& filesystem, const char* path, uint32_t blockSize, bool bWrite) noexcept;
+        void openClose(const Filesystem& filesystem, const char* path) noexcept;
+        void syncLatency(const Filesystem& filesystem, const char* path) noexcept;
+    };
+}
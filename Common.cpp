@@ -3,39 +3,157 @@
 #include <new>
 #include <utility>
 
-UFZ::Application::Application(std::vector<UWidget*> widgetsRef, void* userPointer, const std::function<void(Application&)>& begin, const uint32_t tickPeriod) noexcept
+#ifdef UFZ_LATENCY_PROFILING
+#include <furi_hal_cortex.h>
+#include <stm32wbxx.h>
+#endif
+
+#define TAG "UFZ"
+
+#ifdef UFZ_SCENE_HOOKS
+template<size_t id>
+void UFZ::Application::enterHook(void* context) noexcept
+{
+    auto* app = static_cast<Application*>(context);
+#ifdef UFZ_LATENCY_PROFILING
+    const uint32_t start = LatencyProfiler::now();
+#endif
+    app->enterCallbacks[id](context);
+#ifdef UFZ_LATENCY_PROFILING
+    app->latencyProfiler.record(id, LatencyProfiler::Kind::Enter, start);
+#endif
+#ifdef UFZ_MEMORY_PROFILING
+    app->memoryProfiler.sample(id, MemoryProfiler::Kind::Enter);
+#endif
+}
+
+template<size_t id>
+bool UFZ::Application::eventHook(void* context, const SceneManagerEvent event) noexcept
 {
-    run(std::move(widgetsRef), userPointer, begin, tickPeriod);
+    auto* app = static_cast<Application*>(context);
+#ifdef UFZ_LATENCY_PROFILING
+    const uint32_t start = LatencyProfiler::now();
+    const bool bResult = app->eventCallbacks[id](context, event);
+
+    auto kind = LatencyProfiler::Kind::Custom;
+    if (event.type == SceneManagerEventTypeBack)
+        kind = LatencyProfiler::Kind::Back;
+    else if (event.type == SceneManagerEventTypeTick)
+        kind = LatencyProfiler::Kind::Tick;
+    app->latencyProfiler.record(id, kind, start);
+    return bResult;
+#else
+    return app->eventCallbacks[id](context, event);
+#endif
 }
 
-// Single-use per Application instance: the callback vectors below are appended to, not cleared,
-// so calling run() a second time would build handlers from the previous run's stale callbacks.
-void UFZ::Application::run(std::vector<UWidget*> widgetsRef, void* userPointer, const std::function<void(Application&)>& begin, const uint32_t tickPeriod) noexcept
+template<size_t id>
+void UFZ::Application::exitHook(void* context) noexcept
+{
+    auto* app = static_cast<Application*>(context);
+#ifdef UFZ_LATENCY_PROFILING
+    const uint32_t start = LatencyProfiler::now();
+#endif
+    app->exitCallbacks[id](context);
+#ifdef UFZ_LATENCY_PROFILING
+    app->latencyProfiler.record(id, LatencyProfiler::Kind::Exit, start);
+#endif
+#ifdef UFZ_MEMORY_PROFILING
+    app->memoryProfiler.sample(id, MemoryProfiler::Kind::Exit);
+#endif
+}
+#endif
+
+UFZ::Application::Application(std::vector<UWidget*> widgetsRef, void* userPointer, const std::function<void(Application&)>& begin, const uint32_t tickPeriod, const size_t arenaSize) noexcept
+{
+    run(std::move(widgetsRef), userPointer, begin, tickPeriod, arenaSize);
+}
+
+// Single-use per Application instance: the arena is only released in destroy(), so calling run()
+// a second time would allocate a new one on top of the first.
+void UFZ::Application::run(std::vector<UWidget*> widgetsRef, void* userPointer, const std::function<void(Application&)>& begin, const uint32_t tickPeriod, const size_t arenaSize) noexcept
 {
     widgets = std::move(widgetsRef);
     tickInterval = tickPeriod;
     ctx = userPointer;
 
     uint32_t size = static_cast<uint32_t>(widgets.size());
-    enterCallbacks.reserve(size);
-    eventCallbacks.reserve(size);
-    exitCallbacks.reserve(size);
 
-    for (const auto& a : widgets)
+    // Everything the wrapper keeps for the lifetime of the application comes out of a single block
+    arena.init(Arena::sizeFor<AppSceneOnEnterCallback>(size) +
+               Arena::sizeFor<AppSceneOnEventCallback>(size) +
+               Arena::sizeFor<AppSceneOnExitCallback>(size) +
+               EventQueue::arenaSize() + TimerService::arenaSize() + arenaSize
+#ifdef UFZ_SCENE_HOOKS
+               + Arena::sizeFor<AppSceneOnEnterCallback>(size)
+               + Arena::sizeFor<AppSceneOnEventCallback>(size)
+               + Arena::sizeFor<AppSceneOnExitCallback>(size)
+#endif
+#ifdef UFZ_MEMORY_PROFILING
+               + MemoryProfiler::arenaSize()
+#endif
+#ifdef UFZ_LATENCY_PROFILING
+               + LatencyProfiler::arenaSize(size)
+#endif
+               );
+
+    enterCallbacks = arena.allocate<AppSceneOnEnterCallback>(size);
+    eventCallbacks = arena.allocate<AppSceneOnEventCallback>(size);
+    exitCallbacks = arena.allocate<AppSceneOnExitCallback>(size);
+    furi_check(size == 0 || (enterCallbacks != nullptr && eventCallbacks != nullptr && exitCallbacks != nullptr));
+
+    for (uint32_t i = 0; i < size; i++)
     {
-        enterCallbacks.push_back(a->enter);
-        eventCallbacks.push_back(a->event);
-        exitCallbacks.push_back(a->exit);
+        enterCallbacks[i] = widgets[i]->enter;
+        eventCallbacks[i] = widgets[i]->event;
+        exitCallbacks[i] = widgets[i]->exit;
     }
 
     // SceneManagerHandlers::scene_num is const, so the struct cannot be assigned field-by-field.
     // Construct it in place with placement new instead of casting away const (which is UB).
+#ifdef UFZ_SCENE_HOOKS
+    static constexpr Hooks hooks = makeHooks(std::make_index_sequence<maxHookedScenes>{});
+    hookedEnterCallbacks = arena.allocate<AppSceneOnEnterCallback>(size);
+    hookedEventCallbacks = arena.allocate<AppSceneOnEventCallback>(size);
+    hookedExitCallbacks = arena.allocate<AppSceneOnExitCallback>(size);
+    furi_check(size == 0 || (hookedEnterCallbacks != nullptr && hookedEventCallbacks != nullptr && hookedExitCallbacks != nullptr));
+
+    // Profiling an application is no reason to stop it from starting, extra scenes just run without the hooks
+    for (uint32_t i = 0; i < size; i++)
+    {
+        hookedEnterCallbacks[i] = i < maxHookedScenes ? hooks.enter[i] : enterCallbacks[i];
+        hookedEventCallbacks[i] = i < maxHookedScenes ? hooks.event[i] : eventCallbacks[i];
+        hookedExitCallbacks[i] = i < maxHookedScenes ? hooks.exit[i] : exitCallbacks[i];
+    }
+    if (size > maxHookedScenes)
+        FURI_LOG_W(TAG, "Only the first %zu of %lu scenes are profiled", maxHookedScenes, static_cast<unsigned long>(size));
+
+    new (&handlers) SceneManagerHandlers{
+        hookedEnterCallbacks,
+        hookedEventCallbacks,
+        hookedExitCallbacks,
+        size
+    };
+#else
     new (&handlers) SceneManagerHandlers{
-        enterCallbacks.data(),
-        eventCallbacks.data(),
-        exitCallbacks.data(),
+        enterCallbacks,
+        eventCallbacks,
+        exitCallbacks,
         size
     };
+#endif
+
+#ifdef UFZ_MEMORY_PROFILING
+    memoryProfiler.init(arena);
+#endif
+#ifdef UFZ_LATENCY_PROFILING
+    latencyProfiler.init(arena, static_cast<uint16_t>(size));
+#endif
+    eventQueue.init(*this, arena);
+    timers.init(*this, arena);
+
+    // The wrapper's tables are in place, begin() and the scenes can only allocate or rewind above them
+    arena.floor = arena.offset;
 
     filesystem.init();
     begin(*this);
@@ -57,6 +175,7 @@ void UFZ::Application::initViewDispatcher() noexcept
 {
     viewDispatcher.application = this;
     viewDispatcher.init();
+    worker.init(*this);
 
     for (size_t i = 0; i < widgets.size(); i++)
     {
@@ -72,12 +191,36 @@ void UFZ::Application::initViewDispatcher() noexcept
     view_dispatcher_set_custom_event_callback(viewDispatcher.viewDispatcher, [](void* context, const uint32_t customEvent) -> bool
     {
         furi_assert(context);
-        return static_cast<Application*>(context)->sceneManager.handleCustomEvent(customEvent);
+        auto* app = static_cast<Application*>(context);
+#ifdef UFZ_LATENCY_PROFILING
+        const uint32_t start = LatencyProfiler::now();
+#endif
+        bool bResult = true;
+        if (customEvent == EventQueue::wakeupEvent)
+            app->eventQueue.dispatch();
+        else if (customEvent == TimerService::tickEvent)
+            app->timers.advance();
+        else if (customEvent == BackgroundWorker::showEvent || customEvent == BackgroundWorker::doneEvent)
+            app->worker.handle(customEvent);
+        else
+            bResult = app->sceneManager.handleCustomEvent(customEvent);
+#ifdef UFZ_LATENCY_PROFILING
+        app->latencyProfiler.record(LatencyProfiler::dispatcher, LatencyProfiler::Kind::Custom, start);
+#endif
+        return bResult;
     });
     view_dispatcher_set_navigation_event_callback(viewDispatcher.viewDispatcher, [](void* context) -> bool
     {
         furi_assert(context);
-        return static_cast<Application*>(context)->sceneManager.handleBackEvent();
+        auto* app = static_cast<Application*>(context);
+#ifdef UFZ_LATENCY_PROFILING
+        const uint32_t start = LatencyProfiler::now();
+        const bool bResult = app->sceneManager.handleBackEvent();
+        app->latencyProfiler.record(LatencyProfiler::dispatcher, LatencyProfiler::Kind::Back, start);
+        return bResult;
+#else
+        return app->sceneManager.handleBackEvent();
+#endif
     });
 
     if (tickInterval > 0)
@@ -85,7 +228,14 @@ void UFZ::Application::initViewDispatcher() noexcept
         view_dispatcher_set_tick_event_callback(viewDispatcher.viewDispatcher, [](void* context) -> void
         {
             furi_assert(context);
-            static_cast<Application*>(context)->sceneManager.handleTickEvent();
+            auto* app = static_cast<Application*>(context);
+#ifdef UFZ_LATENCY_PROFILING
+            const uint32_t start = LatencyProfiler::now();
+#endif
+            app->sceneManager.handleTickEvent();
+#ifdef UFZ_LATENCY_PROFILING
+            app->latencyProfiler.record(LatencyProfiler::dispatcher, LatencyProfiler::Kind::Tick, start);
+#endif
         }, tickInterval);
     }
 }
@@ -109,12 +259,32 @@ void UFZ::Application::destroy() noexcept
         // nor backing out of the entry scene pops that scene off the stack, so without this
         // its exit callback would never run. Done while the views still exist so exit
         // handlers may safely touch widgets. Safe if run() never allocated the manager:
-        // SceneManager::stop() null-checks.
+        // SceneManager::stop() null-checks. A job still running is waited for first.
+        worker.free();
         sceneManager.stop();
+        timers.free();
         freeSceneManager();
         freeViewDispatcher();
+        eventQueue.free();
         freeGUI();
         filesystem.destroy();
+
+        // Last, the callback tables handed to the scene manager live in here
+        enterCallbacks = nullptr;
+        eventCallbacks = nullptr;
+        exitCallbacks = nullptr;
+#ifdef UFZ_SCENE_HOOKS
+        hookedEnterCallbacks = nullptr;
+        hookedEventCallbacks = nullptr;
+        hookedExitCallbacks = nullptr;
+#endif
+#ifdef UFZ_MEMORY_PROFILING
+        memoryProfiler.free();
+#endif
+#ifdef UFZ_LATENCY_PROFILING
+        latencyProfiler.free();
+#endif
+        arena.free();
     }
     bDestroyed = true;
 }
@@ -158,6 +328,45 @@ const UFZ::Filesystem& UFZ::Application::getFilesystem() const noexcept
     return filesystem;
 }
 
+UFZ::EventQueue& UFZ::Application::getEventQueue() noexcept
+{
+    return eventQueue;
+}
+
+UFZ::TimerService& UFZ::Application::getTimers() noexcept
+{
+    return timers;
+}
+
+UFZ::BackgroundWorker& UFZ::Application::getWorker() noexcept
+{
+    return worker;
+}
+
+bool UFZ::Application::runInBackground(const std::function<void()>& job, const std::function<void()>& onDone, const uint32_t loadingScene, const uint32_t loadingDelay) noexcept
+{
+    return worker.run(job, onDone, loadingScene, loadingDelay);
+}
+
+UFZ::Arena& UFZ::Application::getArena() noexcept
+{
+    return arena;
+}
+
+#ifdef UFZ_MEMORY_PROFILING
+UFZ::MemoryProfiler& UFZ::Application::getMemoryProfiler() noexcept
+{
+    return memoryProfiler;
+}
+#endif
+
+#ifdef UFZ_LATENCY_PROFILING
+UFZ::LatencyProfiler& UFZ::Application::getLatencyProfiler() noexcept
+{
+    return latencyProfiler;
+}
+#endif
+
 // =====================================================================================================================
 // ================================================== View dispatcher ==================================================
 // =====================================================================================================================
@@ -280,4 +489,772 @@ void UFZ::SceneManager::alloc(const SceneManagerHandlers& handlers, Application&
 void UFZ::SceneManager::free() noexcept
 {
     FREE_GUARD(scene_manager_free, sceneManager);
-}
\ No newline at end of file
+}
+// =====================================================================================================================
+// ==================================================== Event queue ====================================================
+// =====================================================================================================================
+
+void UFZ::EventQueue::init(Application& app, Arena& arena) noexcept
+{
+    application = &app;
+    mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    entries = std::span<Entry>(arena.allocate<Entry>(capacity), capacity);
+    furi_check(entries.data() != nullptr);
+}
+
+void UFZ::EventQueue::free() noexcept
+{
+    FREE_GUARD(furi_mutex_free, mutex);
+    entries = {};
+    count = 0;
+    bWakeupPending = false;
+}
+
+bool UFZ::EventQueue::post(const uint32_t id, const Priority priority, const void* payload, const size_t size) noexcept
+{
+    if (mutex == nullptr || size > payloadSize || id == wakeupEvent)
+        return false;
+
+    furi_check(furi_mutex_acquire(mutex, FuriWaitForever) == FuriStatusOk);
+
+    // Coalesce with a pending event of the same id: keep its place in the queue, take the newest payload and the
+    // highest priority either of them was posted with
+    Entry* entry = nullptr;
+    Entry* freeEntry = nullptr;
+    for (auto& a : entries)
+    {
+        if (a.bPending && a.id == id)
+        {
+            entry = &a;
+            break;
+        }
+        if (!a.bPending && freeEntry == nullptr)
+            freeEntry = &a;
+    }
+
+    if (entry == nullptr)
+    {
+        if (freeEntry == nullptr)
+        {
+            furi_mutex_release(mutex);
+            return false;
+        }
+        entry = freeEntry;
+        entry->id = id;
+        entry->sequence = sequence++;
+        entry->priority = priority;
+        entry->bPending = true;
+        count++;
+    }
+    else if (priority > entry->priority)
+        entry->priority = priority;
+
+    if (size > 0)
+        memcpy(entry->payload, payload, size);
+    entry->size = static_cast<uint8_t>(size);
+
+    const bool bWakeup = !bWakeupPending;
+    bWakeupPending = true;
+    furi_mutex_release(mutex);
+
+    if (bWakeup)
+        application->viewDispatcher.sendCustomEvent(wakeupEvent);
+    return true;
+}
+
+void UFZ::EventQueue::dispatch() noexcept
+{
+    for (size_t i = 0; i < batchSize; i++)
+    {
+        furi_check(furi_mutex_acquire(mutex, FuriWaitForever) == FuriStatusOk);
+
+        Entry* next = nullptr;
+        for (auto& a : entries)
+        {
+            // Sequence numbers are compared by difference so that wrapping around does not reorder the queue
+            if (a.bPending && (next == nullptr || a.priority > next->priority ||
+                (a.priority == next->priority && static_cast<int32_t>(a.sequence - next->sequence) < 0)))
+                next = &a;
+        }
+
+        if (next == nullptr)
+        {
+            bWakeupPending = false;
+            furi_mutex_release(mutex);
+            return;
+        }
+
+        current = *next;
+        next->bPending = false;
+        count--;
+
+        // Events posted after this point queue a wakeup of their own
+        const bool bMore = count > 0;
+        if (!bMore)
+            bWakeupPending = false;
+        furi_mutex_release(mutex);
+
+        UNUSED(application->sceneManager.handleCustomEvent(current.id));
+        current.size = 0;
+
+        if (!bMore)
+            return;
+    }
+
+    // Still events left, queue another wakeup behind whatever input arrived in the meantime
+    application->viewDispatcher.sendCustomEvent(wakeupEvent);
+}
+
+const void* UFZ::EventQueue::getPayload() const noexcept
+{
+    return current.size > 0 ? current.payload : nullptr;
+}
+
+size_t UFZ::EventQueue::getPayloadSize() const noexcept
+{
+    return current.size;
+}
+
+size_t UFZ::EventQueue::pending() const noexcept
+{
+    return count;
+}
+
+// =====================================================================================================================
+// =================================================== Timer service ===================================================
+// =====================================================================================================================
+
+void UFZ::TimerService::init(Application& app, Arena& arena) noexcept
+{
+    application = &app;
+    nodes = std::span<Node>(arena.allocate<Node>(capacity), capacity);
+    furi_check(nodes.data() != nullptr);
+    memset(wheel, none, sizeof(wheel));
+
+    // Runs on the timer service thread, so it only asks the GUI thread to advance the wheel. At most one tick event
+    // is queued at a time; a late one simply advances the wheel by several ticks.
+    timer = furi_timer_alloc([](void* context) -> void
+    {
+        auto* self = static_cast<TimerService*>(context);
+        if (!self->bTickPending.exchange(true))
+            self->application->viewDispatcher.sendCustomEvent(tickEvent);
+    }, FuriTimerTypeOnce, this);
+}
+
+void UFZ::TimerService::free() noexcept
+{
+    if (timer != nullptr)
+    {
+        furi_timer_stop(timer);
+        furi_timer_free(timer);
+        timer = nullptr;
+    }
+    nodes = {};
+    count = 0;
+}
+
+uint32_t UFZ::TimerService::start(const uint32_t event, const uint32_t milliseconds, const bool bRepeat) noexcept
+{
+    if (timer == nullptr)
+        return 0;
+
+    uint8_t i = 0;
+    while (i < nodes.size() && nodes[i].bActive)
+        i++;
+    if (i == nodes.size())
+        return 0;
+
+    // The wheel only moves when a timer is due, so it may be behind the kernel tick. The expiry is counted from the
+    // current time, not from where the wheel stopped.
+    uint32_t lag = 0;
+    if (count == 0)
+    {
+        lastTick = furi_get_tick();
+        bTickPending = false;
+    }
+    else
+        lag = (furi_get_tick() - lastTick) / furi_ms_to_ticks(resolution);
+
+    const uint32_t ticks = (milliseconds + resolution - 1) / resolution;
+    auto& node = nodes[i];
+    node.event = event;
+    node.period = bRepeat ? (ticks == 0 ? 1 : ticks) : 0;
+    node.expiry = now + lag + (ticks == 0 ? 1 : ticks);
+    node.generation++;
+    node.bActive = true;
+    link(i);
+    count++;
+    rearm();
+
+    // Handle 0 is reserved for failure; the generation keeps a stale handle from stopping a reused node
+    return (static_cast<uint32_t>(node.generation) << 8) | (i + 1u);
+}
+
+bool UFZ::TimerService::stop(const uint32_t handle) noexcept
+{
+    const uint32_t i = (handle & 0xFF) - 1;
+    if (handle == 0 || i >= nodes.size())
+        return false;
+
+    auto& node = nodes[i];
+    if (!node.bActive || node.generation != static_cast<uint8_t>(handle >> 8))
+        return false;
+
+    unlink(static_cast<uint8_t>(i));
+    node.bActive = false;
+    count--;
+    rearm();
+    return true;
+}
+
+void UFZ::TimerService::stopAll() noexcept
+{
+    for (uint8_t i = 0; i < nodes.size(); i++)
+    {
+        if (nodes[i].bActive)
+        {
+            unlink(i);
+            nodes[i].bActive = false;
+        }
+    }
+    if (count > 0 && timer != nullptr)
+        furi_timer_stop(timer);
+    count = 0;
+}
+
+size_t UFZ::TimerService::active() const noexcept
+{
+    return count;
+}
+
+// Places a node in the slot for its expiry. Each level covers slots times the range of the one below it; a timer
+// further out than the top level can reach is parked in its last slot and placed again once that slot cascades.
+void UFZ::TimerService::link(const uint8_t i) noexcept
+{
+    auto& node = nodes[i];
+    const uint32_t delta = node.expiry - now;
+
+    uint8_t level = 0;
+    uint32_t expiry = node.expiry;
+    while (level < levels - 1 && delta >= (1u << (slotBits * (level + 1))))
+        level++;
+    if (delta >= (1u << (slotBits * levels)))
+        expiry = now + (1u << (slotBits * levels)) - 1;
+
+    node.level = level;
+    node.slot = static_cast<uint8_t>((expiry >> (slotBits * level)) & (slots - 1));
+    node.prev = none;
+    node.next = wheel[level][node.slot];
+    if (node.next != none)
+        nodes[node.next].prev = i;
+    wheel[level][node.slot] = i;
+}
+
+void UFZ::TimerService::unlink(const uint8_t i) noexcept
+{
+    const auto& node = nodes[i];
+    if (node.prev != none)
+        nodes[node.prev].next = node.next;
+    else
+        wheel[node.level][node.slot] = node.next;
+    if (node.next != none)
+        nodes[node.next].prev = node.prev;
+}
+
+void UFZ::TimerService::cascade(const size_t level) noexcept
+{
+    const uint32_t slot = (now >> (slotBits * level)) & (slots - 1);
+    uint8_t i = wheel[level][slot];
+    wheel[level][slot] = none;
+
+    while (i != none)
+    {
+        const uint8_t next = nodes[i].next;
+        link(i);
+        i = next;
+    }
+}
+
+void UFZ::TimerService::advance() noexcept
+{
+    bTickPending = false;
+
+    const uint32_t tick = furi_get_tick();
+    const uint32_t step = furi_ms_to_ticks(resolution);
+    uint32_t elapsed = (tick - lastTick) / step;
+    lastTick += elapsed * step;
+    const uint32_t target = now + elapsed;
+
+    // Expired events are collected first and sent after the wheel is consistent again, so scene handlers are free to
+    // start and stop timers. Every node fires at most once per call, so capacity entries always hold them all.
+    uint32_t fired[capacity];
+    size_t firedCount = 0;
+
+    while (elapsed-- > 0 && count > 0)
+    {
+        now++;
+        for (size_t level = levels - 1; level > 0; level--)
+            if ((now & ((1u << (slotBits * level)) - 1)) == 0)
+                cascade(level);
+
+        const uint32_t slot = now & (slots - 1);
+        uint8_t i = wheel[0][slot];
+        wheel[0][slot] = none;
+
+        while (i != none)
+        {
+            auto& node = nodes[i];
+            const uint8_t next = node.next;
+
+            if (static_cast<int32_t>(node.expiry - now) > 0)
+                link(i);
+            else
+            {
+                fired[firedCount++] = node.event;
+
+                // A repeating timer that fell behind skips the periods it missed instead of firing for each of them,
+                // keeping its phase
+                if (node.period > 0)
+                {
+                    node.expiry = now + node.period;
+                    if (static_cast<int32_t>(node.expiry - target) <= 0)
+                        node.expiry += ((target - node.expiry) / node.period + 1) * node.period;
+                    link(i);
+                }
+                else
+                {
+                    node.bActive = false;
+                    count--;
+                }
+            }
+            i = next;
+        }
+    }
+
+    rearm();
+    for (size_t i = 0; i < firedCount; i++)
+        UNUSED(application->sceneManager.handleCustomEvent(fired[i]));
+}
+
+// Arms the FuriTimer for the nearest expiry, counted from the kernel tick the wheel was last synchronised to
+void UFZ::TimerService::rearm() noexcept
+{
+    uint32_t nearest = UINT32_MAX;
+    for (const auto& a : nodes)
+        if (a.bActive && a.expiry - now < nearest)
+            nearest = a.expiry - now;
+
+    if (nearest == UINT32_MAX)
+    {
+        furi_timer_stop(timer);
+        return;
+    }
+
+    const uint32_t due = lastTick + nearest * furi_ms_to_ticks(resolution);
+    const auto remaining = static_cast<int32_t>(due - furi_get_tick());
+    furi_timer_start(timer, remaining > 0 ? static_cast<uint32_t>(remaining) : 1);
+}
+
+// =====================================================================================================================
+// ================================================= Background worker =================================================
+// =====================================================================================================================
+
+void UFZ::BackgroundWorker::init(Application& app) noexcept
+{
+    application = &app;
+    timer = furi_timer_alloc([](void* context) -> void
+    {
+        furi_assert(context);
+        auto* self = static_cast<BackgroundWorker*>(context);
+        self->firedGeneration.store(self->generation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        self->application->viewDispatcher.sendCustomEvent(showEvent);
+    }, FuriTimerTypeOnce, this);
+}
+
+void UFZ::BackgroundWorker::free() noexcept
+{
+    if (thread != nullptr)
+    {
+        furi_thread_flags_set(furi_thread_get_id(thread), exitFlag);
+        furi_thread_join(thread);
+        furi_thread_free(thread);
+        thread = nullptr;
+    }
+    if (timer != nullptr)
+    {
+        furi_timer_stop(timer);
+        furi_timer_free(timer);
+        timer = nullptr;
+    }
+    current = nullptr;
+    done = nullptr;
+    bBusy = false;
+    bShown = false;
+}
+
+bool UFZ::BackgroundWorker::run(const std::function<void()>& job, const std::function<void()>& onDone, const uint32_t loadingScene, const uint32_t loadingDelay) noexcept
+{
+    if (bBusy || timer == nullptr)
+        return false;
+
+    if (thread == nullptr)
+    {
+        thread = furi_thread_alloc_ex("UFZWorker", stackSize, [](void* context) -> int32_t
+        {
+            auto* self = static_cast<BackgroundWorker*>(context);
+            while (true)
+            {
+                const uint32_t flags = furi_thread_flags_wait(jobFlag | exitFlag, FuriFlagWaitAny, FuriWaitForever);
+                if ((flags & FuriFlagError) != 0)
+                    continue;
+                if ((flags & jobFlag) != 0)
+                {
+                    self->current();
+                    self->application->viewDispatcher.sendCustomEvent(doneEvent);
+                }
+                if ((flags & exitFlag) != 0)
+                    return 0;
+            }
+        }, this);
+        furi_thread_start(thread);
+    }
+
+    current = job;
+    done = onDone;
+    scene = loadingScene;
+    bBusy = true;
+    bShown = false;
+    generation.fetch_add(1, std::memory_order_relaxed);
+
+    const uint32_t ticks = furi_ms_to_ticks(loadingDelay);
+    furi_timer_start(timer, ticks > 0 ? ticks : 1);
+    furi_thread_flags_set(furi_thread_get_id(thread), jobFlag);
+    return true;
+}
+
+void UFZ::BackgroundWorker::handle(const uint32_t event) noexcept
+{
+    if (!bBusy)
+        return;
+
+    if (event == showEvent)
+    {
+        // The show timer may have fired just as the job finished, doneEvent is then already queued behind this. If
+        // onDone already started another job, the event belongs to the old one.
+        if (!bShown && firedGeneration.load(std::memory_order_relaxed) == generation.load(std::memory_order_relaxed))
+        {
+            bShown = true;
+            application->sceneManager.nextScene(scene);
+        }
+        return;
+    }
+
+    furi_timer_stop(timer);
+    if (bShown)
+        UNUSED(application->sceneManager.previousScene());
+    bShown = false;
+
+    // Cleared before calling onDone so that it can start the next job
+    const std::function<void()> callback = std::move(done);
+    current = nullptr;
+    done = nullptr;
+    bBusy = false;
+    if (callback)
+        callback();
+}
+
+void UFZ::BackgroundWorker::setStackSize(const uint32_t size) noexcept
+{
+    stackSize = size;
+}
+
+bool UFZ::BackgroundWorker::isBusy() const noexcept
+{
+    return bBusy;
+}
+
+// =====================================================================================================================
+// ======================================================= Arena =======================================================
+// =====================================================================================================================
+
+void UFZ::Arena::init(const size_t bytes) noexcept
+{
+    free();
+    buffer = static_cast<uint8_t*>(malloc(bytes));
+    size = buffer != nullptr ? bytes : 0;
+    peakOffset = 0;
+}
+
+void UFZ::Arena::free() noexcept
+{
+    if (buffer != nullptr)
+        ::free(buffer);
+    buffer = nullptr;
+    size = 0;
+    offset = 0;
+    floor = 0;
+}
+
+void* UFZ::Arena::allocate(const size_t bytes, const size_t alignment) noexcept
+{
+    // Align the address rather than the offset, the block itself is only as aligned as malloc makes it
+    const uintptr_t base = reinterpret_cast<uintptr_t>(buffer);
+    const uintptr_t aligned = (base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    const size_t start = aligned - base;
+
+    if (buffer == nullptr || start > size || bytes > size - start)
+        return nullptr;
+
+    offset = start + bytes;
+    if (offset > peakOffset)
+        peakOffset = offset;
+    return buffer + start;
+}
+
+size_t UFZ::Arena::mark() const noexcept
+{
+    return offset;
+}
+
+void UFZ::Arena::rewind(const size_t marker) noexcept
+{
+    if (marker <= offset)
+        offset = marker < floor ? floor : marker;
+}
+
+size_t UFZ::Arena::capacity() const noexcept
+{
+    return size;
+}
+
+size_t UFZ::Arena::used() const noexcept
+{
+    return offset;
+}
+
+size_t UFZ::Arena::peak() const noexcept
+{
+    return peakOffset;
+}
+
+// =====================================================================================================================
+// ================================================== Memory profiler ==================================================
+// =====================================================================================================================
+
+#ifdef UFZ_MEMORY_PROFILING
+void UFZ::MemoryProfiler::init(Arena& arena) noexcept
+{
+    samples = std::span<Sample>(arena.allocate<Sample>(capacity), capacity);
+    furi_check(samples.data() != nullptr);
+    clear();
+}
+
+void UFZ::MemoryProfiler::free() noexcept
+{
+    samples = {};
+    clear();
+}
+
+void UFZ::MemoryProfiler::sample(const uint16_t scene, const Kind kind) noexcept
+{
+    if (samples.empty())
+        return;
+
+    auto& a = samples[head];
+    a.tick = furi_get_tick();
+    a.freeHeap = memmgr_get_free_heap();
+    a.minimumFreeHeap = memmgr_get_minimum_free_heap();
+    a.stackSpace = furi_thread_get_stack_space(furi_thread_get_current_id());
+    a.scene = scene;
+    a.kind = kind;
+
+    head = (head + 1) % capacity;
+    if (count < capacity)
+        count++;
+}
+
+const UFZ::MemoryProfiler::Sample& UFZ::MemoryProfiler::get(const size_t i) const noexcept
+{
+    furi_assert(i < count);
+    return samples[(head + capacity - count + i) % capacity];
+}
+
+size_t UFZ::MemoryProfiler::size() const noexcept
+{
+    return count;
+}
+
+void UFZ::MemoryProfiler::clear() noexcept
+{
+    head = 0;
+    count = 0;
+}
+
+void UFZ::MemoryProfiler::render(const TextBox& textBox, FuriString* out) const noexcept
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto& a = get(i);
+        furi_string_cat_printf(out, "%c%u heap %lu min %lu stk %lu\n", a.kind == Kind::Enter ? '>' : '<', a.scene,
+                               static_cast<unsigned long>(a.freeHeap), static_cast<unsigned long>(a.minimumFreeHeap), static_cast<unsigned long>(a.stackSpace));
+    }
+    UNUSED(textBox.setText(furi_string_get_cstr(out)));
+}
+
+bool UFZ::MemoryProfiler::dump(const Filesystem& filesystem, const char* path) const noexcept
+{
+    File file(filesystem, path, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    if (!file.isOpen())
+        return false;
+
+    static constexpr char header[] = "tick,scene,event,free_heap,minimum_free_heap,stack_space\n";
+    bool bResult = file.write(header, sizeof(header) - 1) == sizeof(header) - 1;
+
+    char line[80];
+    for (size_t i = 0; i < count && bResult; i++)
+    {
+        const auto& a = get(i);
+        const int length = snprintf(line, sizeof(line), "%lu,%u,%s,%lu,%lu,%lu\n", static_cast<unsigned long>(a.tick), a.scene,
+                                    a.kind == Kind::Enter ? "enter" : "exit", static_cast<unsigned long>(a.freeHeap),
+                                    static_cast<unsigned long>(a.minimumFreeHeap), static_cast<unsigned long>(a.stackSpace));
+        bResult = length > 0 && file.write(line, length) == static_cast<size_t>(length);
+    }
+    return bResult;
+}
+#endif
+
+// =====================================================================================================================
+// ================================================= Latency profiler ==================================================
+// =====================================================================================================================
+
+#ifdef UFZ_LATENCY_PROFILING
+static constexpr const char* latencyKindNames[] = { "enter", "custom", "back", "tick", "exit" };
+
+void UFZ::LatencyProfiler::init(Arena& arena, const uint16_t sceneCount) noexcept
+{
+    const size_t size = (sceneCount + 1) * static_cast<size_t>(Kind::Count);
+    stats = std::span<Stats>(arena.allocate<Stats>(size), size);
+    furi_check(stats.data() != nullptr);
+    scenes = sceneCount;
+    cyclesPerMicrosecond = furi_hal_cortex_instructions_per_microsecond();
+    clear();
+}
+
+void UFZ::LatencyProfiler::free() noexcept
+{
+    stats = {};
+    scenes = 0;
+}
+
+// The firmware enables the cycle counter at boot for its microsecond delays
+uint32_t UFZ::LatencyProfiler::now() noexcept
+{
+    return DWT->CYCCNT;
+}
+
+UFZ::LatencyProfiler::Stats* UFZ::LatencyProfiler::find(const uint16_t scene, const Kind kind) const noexcept
+{
+    // The dispatcher row sits after the last scene
+    const size_t row = scene == dispatcher ? scenes : scene;
+    if (stats.empty() || row > scenes || kind >= Kind::Count)
+        return nullptr;
+    return &stats[row * static_cast<size_t>(Kind::Count) + static_cast<size_t>(kind)];
+}
+
+void UFZ::LatencyProfiler::record(const uint16_t scene, const Kind kind, const uint32_t startCycles) noexcept
+{
+    // Unsigned subtraction stays correct across one wrap of the 32-bit counter
+    const uint32_t microseconds = (now() - startCycles) / cyclesPerMicrosecond;
+    Stats* a = find(scene, kind);
+    if (a == nullptr)
+        return;
+
+    if (a->count == 0 || microseconds < a->min)
+        a->min = microseconds;
+    if (microseconds > a->max)
+        a->max = microseconds;
+    a->total += microseconds;
+    a->count++;
+
+    size_t bucket = 0;
+    while (bucket < buckets - 1 && microseconds >= (1u << bucket))
+        bucket++;
+    if (a->histogram[bucket] < UINT16_MAX)
+        a->histogram[bucket]++;
+}
+
+UFZ::LatencyProfiler::Summary UFZ::LatencyProfiler::get(const uint16_t scene, const Kind kind) const noexcept
+{
+    Summary result{};
+    const Stats* a = find(scene, kind);
+    if (a == nullptr || a->count == 0)
+        return result;
+
+    result.count = a->count;
+    result.min = a->min;
+    result.max = a->max;
+    result.avg = static_cast<uint32_t>(a->total / a->count);
+
+    // The histogram saturates, so the percentile is taken over what it actually counted
+    uint32_t counted = 0;
+    for (const auto& b : a->histogram)
+        counted += b;
+
+    const uint32_t target = counted - counted / 100;
+    uint32_t cumulative = 0;
+    for (size_t i = 0; i < buckets; i++)
+    {
+        cumulative += a->histogram[i];
+        if (cumulative >= target)
+        {
+            result.p99 = i == buckets - 1 ? a->max : (1u << i);
+            break;
+        }
+    }
+
+    // A bucket bound can overshoot the longest duration actually seen
+    if (result.p99 > result.max)
+        result.p99 = result.max;
+    return result;
+}
+
+void UFZ::LatencyProfiler::clear() noexcept
+{
+    for (auto& a : stats)
+        a = Stats{};
+}
+
+bool UFZ::LatencyProfiler::dump(const Filesystem& filesystem, const char* path) const noexcept
+{
+    File file(filesystem, path, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    if (!file.isOpen())
+        return false;
+
+    static constexpr char header[] = "scene,kind,count,min_us,avg_us,max_us,p99_us\n";
+    bool bResult = file.write(header, sizeof(header) - 1) == sizeof(header) - 1;
+
+    char line[96];
+    for (size_t row = 0; row <= scenes && bResult; row++)
+    {
+        const uint16_t scene = row == scenes ? dispatcher : static_cast<uint16_t>(row);
+        for (size_t kind = 0; kind < static_cast<size_t>(Kind::Count) && bResult; kind++)
+        {
+            const Summary a = get(scene, static_cast<Kind>(kind));
+            if (a.count == 0)
+                continue;
+
+            int length;
+            if (scene == dispatcher)
+                length = snprintf(line, sizeof(line), "dispatcher,%s,%lu,%lu,%lu,%lu,%lu\n", latencyKindNames[kind],
+                                  static_cast<unsigned long>(a.count), static_cast<unsigned long>(a.min), static_cast<unsigned long>(a.avg),
+                                  static_cast<unsigned long>(a.max), static_cast<unsigned long>(a.p99));
+            else
+                length = snprintf(line, sizeof(line), "%u,%s,%lu,%lu,%lu,%lu,%lu\n", scene, latencyKindNames[kind],
+                                  static_cast<unsigned long>(a.count), static_cast<unsigned long>(a.min), static_cast<unsigned long>(a.avg),
+                                  static_cast<unsigned long>(a.max), static_cast<unsigned long>(a.p99));
+            bResult = length > 0 && file.write(line, length) == static_cast<size_t>(length);
+        }
+    }
+    return bResult;
+}
+#endif
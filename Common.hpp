@@ -1,6 +1,12 @@
 #pragma once
 #include <vector>
 #include <functional>
+#include <type_traits>
+#include <atomic>
+#include <new>
+#include <span>
+#include <utility>
+#include <cstring>
 #include <furi.h>
 #include <storage/storage.h>
 #include <gui/gui.h>
@@ -22,10 +28,20 @@
 #define EXIT_SCENE(x) (x)->getSceneManager().stop()
 #define EXIT_APPLICATION(x) (x)->getViewDispatcher().stop()
 
+// Opt-in instrumentation, enable it by adding the define to the cdefines of your application.fam. When none is defined
+// the scene callbacks are handed to the scene manager untouched and the profilers are not compiled at all.
+//
+// UFZ_MEMORY_PROFILING - samples heap and stack usage on every scene enter and exit, see UFZ::MemoryProfiler
+// UFZ_LATENCY_PROFILING - times every scene callback and dispatcher event, see UFZ::LatencyProfiler
+#if defined(UFZ_MEMORY_PROFILING) || defined(UFZ_LATENCY_PROFILING)
+    #define UFZ_SCENE_HOOKS
+#endif
+
 namespace UFZ
 {
     class UWidget;
     class Application;
+    class TextBox;
 
     class ViewDispatcher
     {
@@ -80,6 +96,649 @@ namespace UFZ
         Application* application = nullptr;
     };
 
+    // Application-scoped bump allocator. One block is allocated when the application starts and everything carved from
+    // it is released together when the application is destroyed, so long-lived objects do not fragment the heap.
+    // Objects are never destroyed individually, hence only trivially destructible types can be allocated. Not
+    // thread-safe, allocate from the GUI thread or the begin callback.
+    class Arena
+    {
+    public:
+        Arena() = default;
+
+        // Owns the block, copying would free it twice
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // Returns nullptr if the arena can not fit size more bytes at the given alignment
+        [[nodiscard]] void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) noexcept;
+
+        // Allocates and value-initialises count objects of type T
+        template<typename T>
+        [[nodiscard]] T* allocate(const size_t count = 1) noexcept
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "Arena objects are released without calling their destructors");
+            auto* result = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+            if (result != nullptr)
+                for (size_t i = 0; i < count; i++)
+                    new (result + i) T();
+            return result;
+        }
+
+        // Bytes needed to allocate count objects of type T regardless of the arena's current alignment
+        template<typename T>
+        [[nodiscard]] static constexpr size_t sizeFor(const size_t count = 1) noexcept
+        {
+            return sizeof(T) * count + alignof(T) - 1;
+        }
+
+        // Everything allocated after mark() is released by rewind(), e.g. to reuse a region for one scene at a time.
+        // rewind() never releases the wrapper's own tables, which are allocated before the begin callback runs.
+        [[nodiscard]] size_t mark() const noexcept;
+        void rewind(size_t marker) noexcept;
+
+        [[nodiscard]] size_t capacity() const noexcept;
+        [[nodiscard]] size_t used() const noexcept;
+        [[nodiscard]] size_t peak() const noexcept;
+    private:
+        friend class Application;
+
+        uint8_t* buffer = nullptr;
+        size_t size = 0;
+        size_t offset = 0;
+        size_t peakOffset = 0;
+        size_t floor = 0;
+
+        void init(size_t bytes) noexcept;
+        void free() noexcept;
+    };
+
+    // Sits in front of ViewDispatcher::sendCustomEvent. Events posted here wait in a small fixed table instead of the
+    // dispatcher's queue: posting an id that is already pending only replaces its payload, and pending events are
+    // delivered highest priority first. The dispatcher only ever holds a single wakeup event for the whole table, so
+    // a worker reporting progress cannot bury input events behind hundreds of custom events. Events still reach the
+    // scenes through SceneManager::handleCustomEvent.
+    class EventQueue
+    {
+    public:
+        enum class Priority : uint8_t
+        {
+            Low,
+            Normal,
+            High
+        };
+
+        static constexpr size_t capacity = 16;
+        static constexpr size_t payloadSize = 16;
+
+        // Events delivered per wakeup before yielding to the dispatcher so that queued input gets a chance to run
+        static constexpr size_t batchSize = 4;
+
+        // Reserved custom event id used to wake the dispatcher up, do not use it for your own events
+        static constexpr uint32_t wakeupEvent = UINT32_MAX;
+
+        EventQueue() = default;
+
+        // Owns a mutex and is referenced by the application, copying it would double-free the mutex
+        EventQueue(const EventQueue&) = delete;
+        EventQueue& operator=(const EventQueue&) = delete;
+
+        // Safe to call from any thread. Returns false if the event is new and the table is full, or if the payload is
+        // larger than payloadSize.
+        bool post(uint32_t id, Priority priority = Priority::Normal, const void* payload = nullptr, size_t size = 0) noexcept;
+
+        template<typename T>
+        bool post(const uint32_t id, const T& payload, const Priority priority = Priority::Normal) noexcept
+        {
+            static_assert(sizeof(T) <= payloadSize, "The payload does not fit in an event, pass a pointer instead");
+            static_assert(std::is_trivially_copyable_v<T>, "Event payloads are copied bytewise");
+            return post(id, priority, &payload, sizeof(T));
+        }
+
+        // Payload of the event currently being handled. Only valid inside the scene's event callback.
+        [[nodiscard]] const void* getPayload() const noexcept;
+        [[nodiscard]] size_t getPayloadSize() const noexcept;
+
+        template<typename T>
+        [[nodiscard]] const T* getPayload() const noexcept
+        {
+            return current.size == sizeof(T) ? reinterpret_cast<const T*>(current.payload) : nullptr;
+        }
+
+        [[nodiscard]] size_t pending() const noexcept;
+    private:
+        friend class Application;
+
+        struct Entry
+        {
+            uint32_t id;
+            uint32_t sequence;
+            uint8_t payload[payloadSize];
+            uint8_t size;
+            Priority priority;
+            bool bPending;
+        };
+
+        Application* application = nullptr;
+        FuriMutex* mutex = nullptr;
+
+        std::span<Entry> entries{};
+        Entry current{};
+
+        uint32_t sequence = 0;
+        size_t count = 0;
+        bool bWakeupPending = false;
+
+        [[nodiscard]] static constexpr size_t arenaSize() noexcept
+        {
+            return Arena::sizeFor<Entry>(capacity);
+        }
+
+        void init(Application& app, Arena& arena) noexcept;
+        void free() noexcept;
+
+        void dispatch() noexcept;
+    };
+
+    // Lock-free single-producer/single-consumer ring buffer for streaming data from an interrupt or worker thread to the
+    // GUI thread without taking the model's mutex for every sample. Storage is inline, nothing is allocated after
+    // construction. head and tail sit on cache lines of their own, and each side keeps a stale copy of the other's
+    // index so it only reads the shared one when its copy says the buffer is full or empty.
+    //
+    // The producer calls wake() after pushing, which sends the wakeup event to the GUI unless one is already pending.
+    // The consumer calls acknowledge() when handling that event and then drains the buffer, so however many pushes
+    // happen in between, the dispatcher only ever holds one wakeup. wake() goes through the view dispatcher's queue and
+    // may not be called from an interrupt; push there and call wake() from a timer or thread instead.
+    template<typename T, size_t capacity>
+    class RingBuffer
+    {
+    public:
+        static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "The capacity must be a power of two");
+        static_assert(std::is_trivially_copyable_v<T>, "Items are copied bytewise");
+
+        static constexpr size_t cacheLine = 64;
+
+        RingBuffer() = default;
+
+        // Shared between two threads by address
+        RingBuffer(const RingBuffer&) = delete;
+        RingBuffer& operator=(const RingBuffer&) = delete;
+
+        // Producer side. Pushes as many items as fit and returns how many did, the rest count as dropped.
+        size_t push(const T* items, const size_t count) noexcept
+        {
+            const size_t t = tail.load(std::memory_order_relaxed);
+            if (capacity - (t - cachedHead) < count)
+                cachedHead = head.load(std::memory_order_acquire);
+
+            const size_t space = capacity - (t - cachedHead);
+            const size_t n = count < space ? count : space;
+            write(t, items, n);
+            tail.store(t + n, std::memory_order_release);
+
+            if (n < count)
+                dropped.fetch_add(count - n, std::memory_order_relaxed);
+            return n;
+        }
+
+        bool push(const T& item) noexcept
+        {
+            return push(&item, 1) == 1;
+        }
+
+        // Consumer side. Pops up to count items and returns how many were popped.
+        size_t pop(T* items, const size_t count) noexcept
+        {
+            const size_t h = head.load(std::memory_order_relaxed);
+            if (cachedTail - h < count)
+                cachedTail = tail.load(std::memory_order_acquire);
+
+            const size_t available = cachedTail - h;
+            const size_t n = count < available ? count : available;
+            read(h, items, n);
+            head.store(h + n, std::memory_order_release);
+            return n;
+        }
+
+        bool pop(T& item) noexcept
+        {
+            return pop(&item, 1) == 1;
+        }
+
+        // Exact on either side, approximate anywhere else
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        // Items push() could not fit since construction
+        [[nodiscard]] size_t getDropped() const noexcept
+        {
+            return dropped.load(std::memory_order_relaxed);
+        }
+
+        // Set before either side starts using the buffer
+        void setWakeup(const ViewDispatcher& viewDispatcher, const uint32_t event) noexcept
+        {
+            dispatcher = &viewDispatcher;
+            wakeupEvent = event;
+        }
+
+        // Producer side
+        void wake() noexcept
+        {
+            if (dispatcher != nullptr && !bWakeupPending.exchange(true, std::memory_order_acq_rel))
+                dispatcher->sendCustomEvent(wakeupEvent);
+        }
+
+        // Consumer side, call before draining so that items pushed while draining send a new wakeup
+        void acknowledge() noexcept
+        {
+            bWakeupPending.store(false, std::memory_order_release);
+        }
+    private:
+        alignas(cacheLine) std::atomic<size_t> head = 0;
+        size_t cachedTail = 0;
+
+        alignas(cacheLine) std::atomic<size_t> tail = 0;
+        size_t cachedHead = 0;
+        std::atomic<size_t> dropped = 0;
+
+        alignas(cacheLine) std::atomic<bool> bWakeupPending = false;
+        const ViewDispatcher* dispatcher = nullptr;
+        uint32_t wakeupEvent = 0;
+
+        alignas(cacheLine) T buffer[capacity];
+
+        // Copy n items to or from the ring starting at index, in two pieces when they wrap around its end
+        void write(const size_t index, const T* items, const size_t n) noexcept
+        {
+            const size_t start = index & (capacity - 1);
+            const size_t first = n < capacity - start ? n : capacity - start;
+            memcpy(buffer + start, items, first * sizeof(T));
+            memcpy(buffer, items + first, (n - first) * sizeof(T));
+        }
+
+        void read(const size_t index, T* items, const size_t n) const noexcept
+        {
+            const size_t start = index & (capacity - 1);
+            const size_t first = n < capacity - start ? n : capacity - start;
+            memcpy(items, buffer + start, first * sizeof(T));
+            memcpy(items + first, buffer, (n - first) * sizeof(T));
+        }
+    };
+
+    // One-shot and repeating timers for scenes, delivered as custom events through SceneManager::handleCustomEvent.
+    // Timers live in a three level hierarchical timing wheel advanced by a single one-shot FuriTimer, armed for the
+    // nearest expiry only, so a scene needing a fast timer no longer forces a fast tickPeriod on every other scene and
+    // a lone long timer wakes the GUI thread once. A repeating timer that fell behind fires once and skips the periods
+    // it missed. Not thread-safe: start and stop timers from scene callbacks, i.e. on the GUI thread.
+    class TimerService
+    {
+    public:
+        // Length of one wheel tick in milliseconds, timer periods are rounded up to it
+        static constexpr uint32_t resolution = 10;
+        static constexpr size_t capacity = 16;
+
+        // Reserved custom event id used to advance the wheel, do not use it for your own events
+        static constexpr uint32_t tickEvent = UINT32_MAX - 1;
+
+        TimerService() = default;
+
+        // Owns a FuriTimer whose callback points back at this object
+        TimerService(const TimerService&) = delete;
+        TimerService& operator=(const TimerService&) = delete;
+
+        // Sends event to the current scene after milliseconds, and then every milliseconds if bRepeat is set. Returns
+        // a handle for stop(), or 0 if all timers are in use.
+        [[nodiscard]] uint32_t start(uint32_t event, uint32_t milliseconds, bool bRepeat = false) noexcept;
+
+        // Returns false if the timer has already fired (one-shot) or was stopped before
+        bool stop(uint32_t handle) noexcept;
+        void stopAll() noexcept;
+
+        [[nodiscard]] size_t active() const noexcept;
+    private:
+        friend class Application;
+
+        static constexpr size_t levels = 3;
+        static constexpr uint32_t slotBits = 5;
+        static constexpr uint32_t slots = 1 << slotBits;
+        static constexpr uint8_t none = UINT8_MAX;
+
+        struct Node
+        {
+            uint32_t event;
+            uint32_t expiry;
+            uint32_t period;
+            uint8_t generation;
+            uint8_t level;
+            uint8_t slot;
+            uint8_t next;
+            uint8_t prev;
+            bool bActive;
+        };
+
+        Application* application = nullptr;
+        FuriTimer* timer = nullptr;
+
+        std::span<Node> nodes{};
+        uint8_t wheel[levels][slots]{};
+
+        // Wheel time in ticks of resolution, and the kernel tick it was last synchronised to
+        uint32_t now = 0;
+        uint32_t lastTick = 0;
+        size_t count = 0;
+
+        std::atomic<bool> bTickPending = false;
+
+        [[nodiscard]] static constexpr size_t arenaSize() noexcept
+        {
+            return Arena::sizeFor<Node>(capacity);
+        }
+
+        void init(Application& app, Arena& arena) noexcept;
+        void free() noexcept;
+
+        void link(uint8_t i) noexcept;
+        void unlink(uint8_t i) noexcept;
+        void cascade(size_t level) noexcept;
+        void advance() noexcept;
+        void rearm() noexcept;
+    };
+
+    // Runs one job at a time on a worker thread that is started with the first job and kept for the next ones. If the
+    // job is still running after the given delay the loading scene is pushed, and popped again once the job is done,
+    // so quick jobs never flash it. The loading scene is an ordinary scene of the application, usually one showing a
+    // Loading widget, and should consume back events while it is up. onDone runs on the GUI thread after the loading
+    // scene is gone.
+    class BackgroundWorker
+    {
+    public:
+        static constexpr uint32_t defaultStackSize = 2048;
+
+        // Reserved custom event ids, do not use them for your own events
+        static constexpr uint32_t showEvent = UINT32_MAX - 4;
+        static constexpr uint32_t doneEvent = UINT32_MAX - 5;
+
+        BackgroundWorker() = default;
+
+        // Owns the thread and timer, both of which point back at this object
+        BackgroundWorker(const BackgroundWorker&) = delete;
+        BackgroundWorker& operator=(const BackgroundWorker&) = delete;
+
+        // Returns false if a job is already running
+        bool run(const std::function<void()>& job, const std::function<void()>& onDone, uint32_t loadingScene, uint32_t loadingDelay) noexcept;
+
+        // Only takes effect before the first job starts the thread
+        void setStackSize(uint32_t size) noexcept;
+
+        // True from run() until onDone has returned
+        [[nodiscard]] bool isBusy() const noexcept;
+    private:
+        friend class Application;
+
+        static constexpr uint32_t jobFlag = 1 << 0;
+        static constexpr uint32_t exitFlag = 1 << 1;
+
+        Application* application = nullptr;
+        FuriThread* thread = nullptr;
+        FuriTimer* timer = nullptr;
+        uint32_t stackSize = defaultStackSize;
+
+        // Only touched on the GUI thread, and by the worker while the job is running
+        std::function<void()> current{};
+        std::function<void()> done{};
+        uint32_t scene = 0;
+        bool bBusy = false;
+        bool bShown = false;
+
+        // A custom event carries no payload, so the timer records the generation of the job it fired for. A show event
+        // left over from a job that finished before it was handled then does not skip the next job's delay.
+        std::atomic<uint32_t> generation = 0;
+        std::atomic<uint32_t> firedGeneration = 0;
+
+        void init(Application& app) noexcept;
+        void free() noexcept;
+
+        void handle(uint32_t event) noexcept;
+    };
+
+    // A path stored in a fixed-size char array, so building paths in a directory walk does not allocate. Converts to
+    // const char* and can be passed to every Filesystem and File function taking a path. Operations that would not fit
+    // return false and leave the path unchanged. N includes the terminating null.
+    template<size_t N>
+    class PathBuffer
+    {
+    public:
+        static_assert(N > 1, "A path needs room for at least one character");
+
+        static constexpr const char* appDataRoot = STORAGE_EXT_PATH_PREFIX "/apps_data";
+        static constexpr const char* appAssetsRoot = STORAGE_EXT_PATH_PREFIX "/apps_assets";
+
+        PathBuffer() noexcept = default;
+
+        // Paths that do not fit are left empty
+        PathBuffer(const char* path) noexcept
+        {
+            UNUSED(set(path));
+        }
+
+        bool set(const char* path) noexcept
+        {
+            const size_t size = strlen(path);
+            if (size >= N)
+                return false;
+            memcpy(buffer, path, size + 1);
+            length = size;
+            return true;
+        }
+
+        void clear() noexcept
+        {
+            buffer[0] = '\0';
+            length = 0;
+        }
+
+        // Appends text as is, for example an extension
+        bool append(const char* text) noexcept
+        {
+            return replace(length, 0, text, strlen(text));
+        }
+
+        // Appends a path component with a single '/' between it and the current path
+        bool join(const char* component) noexcept
+        {
+            while (*component == '/')
+                component++;
+
+            const size_t size = strlen(component);
+            const bool bSeparator = length != 0 && buffer[length - 1] != '/';
+            if (length + bSeparator + size >= N)
+                return false;
+
+            if (bSeparator)
+                buffer[length++] = '/';
+            memcpy(buffer + length, component, size + 1);
+            length += size;
+            return true;
+        }
+
+        // Drops the last component, "/ext/a/b" becomes "/ext/a" and "/ext" becomes "/". False if there is no parent.
+        bool parent() noexcept
+        {
+            size_t end = length;
+            while (end > 1 && buffer[end - 1] == '/')
+                end--;
+            while (end > 0 && buffer[end - 1] != '/')
+                end--;
+            if (end == 0 || (end == 1 && length == 1))
+                return false;
+
+            // Keep the root's slash but not the separator before the last component
+            length = end > 1 ? end - 1 : 1;
+            buffer[length] = '\0';
+            return true;
+        }
+
+        // The last component
+        [[nodiscard]] const char* name() const noexcept
+        {
+            const char* slash = strrchr(buffer, '/');
+            return slash == nullptr ? buffer : slash + 1;
+        }
+
+        // The last component's extension including the dot, an empty string if it has none
+        [[nodiscard]] const char* extension() const noexcept
+        {
+            const char* base = name();
+            const char* dot = strrchr(base, '.');
+            return dot == nullptr || dot == base ? buffer + length : dot;
+        }
+
+        // Replaces the extension or adds one if there is none, extension includes the dot or is empty to remove it
+        bool setExtension(const char* extension) noexcept
+        {
+            const size_t start = static_cast<size_t>(this->extension() - buffer);
+            return replace(start, length - start, extension, strlen(extension));
+        }
+
+        // Collapses repeated slashes, removes "." components and trailing slashes and resolves ".." in place. ".."
+        // never goes above the root of an absolute path, a relative path keeps the ones it cannot resolve, so
+        // "a/../../b" becomes "../b".
+        void normalize() noexcept
+        {
+            const bool bAbsolute = buffer[0] == '/';
+            size_t out = bAbsolute ? 1 : 0;
+            size_t in = out;
+
+            // End of the leading ".." components of a relative path, nothing before it can be removed
+            size_t floor = out;
+
+            while (in < length)
+            {
+                while (buffer[in] == '/')
+                    in++;
+                size_t end = in;
+                while (end < length && buffer[end] != '/')
+                    end++;
+
+                const size_t size = end - in;
+                if (size == 2 && buffer[in] == '.' && buffer[in + 1] == '.')
+                {
+                    if (out > floor)
+                    {
+                        out--;
+                        while (out > floor && buffer[out - 1] != '/')
+                            out--;
+                    }
+                    else if (!bAbsolute)
+                    {
+                        // out is at most in, so this only overwrites the component itself
+                        memmove(buffer + out, "../", 3);
+                        out += 3;
+                        floor = out;
+                    }
+                }
+                else if (size != 0 && !(size == 1 && buffer[in] == '.'))
+                {
+                    memmove(buffer + out, buffer + in, size);
+                    out += size;
+                    buffer[out++] = '/';
+                }
+                in = end;
+            }
+
+            // Every copied component was followed by a slash
+            if (out > (bAbsolute ? 1u : 0u))
+                out--;
+            buffer[out] = '\0';
+            length = out;
+        }
+
+        // Rewrites the storage prefixes the storage service would, without a FuriString: "/any" to "/ext", "/data" to
+        // the application's data directory and "/assets" to its assets directory. appId defaults to the current
+        // application's. Unlike Filesystem::resolvePathAndEnsureAppDirectory this does not create the directory. The
+        // result is normalized. The service rejects relative paths, so does this, returning false.
+        bool resolve(const char* appId = nullptr) noexcept
+        {
+            if (buffer[0] != '/')
+                return false;
+            if (appId == nullptr)
+                appId = furi_thread_get_appid(furi_thread_get_current_id());
+
+            PathBuffer result;
+            bool bResult;
+            if (startsWith(STORAGE_ANY_PATH_PREFIX))
+                bResult = result.set(STORAGE_EXT_PATH_PREFIX) && result.append(buffer + strlen(STORAGE_ANY_PATH_PREFIX));
+            else if (startsWith(STORAGE_APP_DATA_PATH_PREFIX))
+                bResult = result.set(appDataRoot) && result.join(appId) && result.append(buffer + strlen(STORAGE_APP_DATA_PATH_PREFIX));
+            else if (startsWith(STORAGE_APP_ASSETS_PATH_PREFIX))
+                bResult = result.set(appAssetsRoot) && result.join(appId) && result.append(buffer + strlen(STORAGE_APP_ASSETS_PATH_PREFIX));
+            else
+                bResult = result.set(buffer);
+
+            if (!bResult)
+                return false;
+            result.normalize();
+            *this = result;
+            return true;
+        }
+
+        // True if the path is prefix itself or inside it
+        [[nodiscard]] bool startsWith(const char* prefix) const noexcept
+        {
+            const size_t size = strlen(prefix);
+            return strncmp(buffer, prefix, size) == 0 && (buffer[size] == '\0' || buffer[size] == '/');
+        }
+
+        [[nodiscard]] const char* c_str() const noexcept
+        {
+            return buffer;
+        }
+
+        operator const char*() const noexcept
+        {
+            return buffer;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return length;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return length == 0;
+        }
+
+        static constexpr size_t capacity() noexcept
+        {
+            return N - 1;
+        }
+    private:
+        char buffer[N]{};
+        size_t length = 0;
+
+        // Replaces count characters at start with size characters from text
+        bool replace(const size_t start, const size_t count, const char* text, const size_t size) noexcept
+        {
+            if (length - count + size >= N)
+                return false;
+            memmove(buffer + start + size, buffer + start + count, length - start - count + 1);
+            memcpy(buffer + start, text, size);
+            length = length - count + size;
+            return true;
+        }
+    };
+
+    class FilesystemBatch;
+    class FilenameIndex;
+
     class Filesystem
     {
     public:
@@ -99,6 +758,9 @@ namespace UFZ
         FS_Error mkdir(const char* path) const noexcept;
         FS_Error filesystemInfo(const char* path, uint64_t* totalSpace, uint64_t* freeSpace) const noexcept;
 
+        // True if the filesystem holding path has at least bytes free, check before preallocating a long recording
+        [[nodiscard]] bool hasFreeSpace(const char* path, uint64_t bytes) const noexcept;
+
         void resolvePathAndEnsureAppDirectory(FuriString* path) const noexcept;
 
         bool areEquivalent(const char* path1, const char* path2) const noexcept;
@@ -112,22 +774,160 @@ namespace UFZ
         bool removeRecursiveSimple(const char* path) const noexcept;
         bool mkdirSimple(const char* path) const noexcept;
         void getNextFilename(const char* dirname, const char* filename, const char* fileExtension, FuriString* nextFilename, uint8_t maxLength) const noexcept;
+
+        // Runs every operation of the batch back to back and stores one result per operation, see FilesystemBatch
+        void run(FilesystemBatch& batch) const noexcept;
     private:
         friend class Application;
         friend class File;
         friend class Directory;
 
+        friend class FilenameIndex;
+
         void init() noexcept;
         void destroy() noexcept;
 
+        // Keep the registered FilenameIndex objects in sync with changes made through this object
+        void notifyCreated(const char* path) const noexcept;
+        void notifyRemoved(const char* path) const noexcept;
+
         ::Storage* storage = nullptr;
+        FilenameIndex* filenameIndices = nullptr;
+        FuriMutex* indicesMutex = nullptr;
+    };
+
+#ifdef UFZ_MEMORY_PROFILING
+    // Keeps a ring of the last `capacity` heap and stack samples taken after each scene enter and exit. Use it to find
+    // the scene sequence leading up to an out-of-memory crash.
+    class MemoryProfiler
+    {
+    public:
+        static constexpr size_t capacity = 32;
+
+        enum class Kind : uint8_t
+        {
+            Enter,
+            Exit
+        };
+
+        struct Sample
+        {
+            uint32_t tick;
+            uint32_t freeHeap;
+            uint32_t minimumFreeHeap;
+            uint32_t stackSpace;
+            uint16_t scene;
+            Kind kind;
+        };
+
+        MemoryProfiler() = default;
+
+        // Takes a sample outside the scene hooks, for example around a suspicious operation
+        void sample(uint16_t scene, Kind kind) noexcept;
+
+        // Sample i counting from the oldest one still in the ring
+        [[nodiscard]] const Sample& get(size_t i) const noexcept;
+        [[nodiscard]] size_t size() const noexcept;
+        void clear() noexcept;
+
+        // Appends one line per sample to out and shows it in textBox. out must outlive the text box's use of it.
+        void render(const TextBox& textBox, FuriString* out) const noexcept;
+
+        // Writes the samples as CSV, returns false if the file could not be written
+        bool dump(const Filesystem& filesystem, const char* path) const noexcept;
+    private:
+        friend class Application;
+
+        std::span<Sample> samples{};
+        size_t head = 0;
+        size_t count = 0;
+
+        [[nodiscard]] static constexpr size_t arenaSize() noexcept
+        {
+            return Arena::sizeFor<Sample>(capacity);
+        }
+
+        void init(Arena& arena) noexcept;
+        void free() noexcept;
     };
+#endif
+
+#ifdef UFZ_LATENCY_PROFILING
+    // Times scene callbacks and view dispatcher events with the DWT cycle counter and aggregates them per scene and
+    // event kind into logarithmic histograms, from which min/avg/max/p99 are derived. Dispatcher callbacks (custom
+    // event, navigation and tick, including the wrapper's own event queue and timers) are reported under the
+    // `dispatcher` scene id.
+    class LatencyProfiler
+    {
+    public:
+        static constexpr uint16_t dispatcher = UINT16_MAX;
+
+        // Bucket i counts durations below 2^i microseconds, the last one everything longer
+        static constexpr size_t buckets = 20;
+
+        enum class Kind : uint8_t
+        {
+            Enter,
+            Custom,
+            Back,
+            Tick,
+            Exit,
+            Count
+        };
+
+        // All values in microseconds. p99 is the upper bound of the histogram bucket containing the 99th percentile.
+        struct Summary
+        {
+            uint32_t count;
+            uint32_t min;
+            uint32_t avg;
+            uint32_t max;
+            uint32_t p99;
+        };
+
+        LatencyProfiler() = default;
+
+        [[nodiscard]] static uint32_t now() noexcept;
+        void record(uint16_t scene, Kind kind, uint32_t startCycles) noexcept;
+
+        [[nodiscard]] Summary get(uint16_t scene, Kind kind) const noexcept;
+        void clear() noexcept;
+
+        // Writes one CSV row per scene and kind that recorded anything, returns false if the file could not be written
+        bool dump(const Filesystem& filesystem, const char* path) const noexcept;
+    private:
+        friend class Application;
+
+        struct Stats
+        {
+            uint64_t total;
+            uint32_t count;
+            uint32_t min;
+            uint32_t max;
+            uint16_t histogram[buckets];
+        };
+
+        std::span<Stats> stats{};
+        uint16_t scenes = 0;
+        uint32_t cyclesPerMicrosecond = 1;
+
+        [[nodiscard]] static constexpr size_t arenaSize(const size_t sceneCount) noexcept
+        {
+            return Arena::sizeFor<Stats>((sceneCount + 1) * static_cast<size_t>(Kind::Count));
+        }
+
+        [[nodiscard]] Stats* find(uint16_t scene, Kind kind) const noexcept;
+
+        void init(Arena& arena, uint16_t sceneCount) noexcept;
+        void free() noexcept;
+    };
+#endif
 
     class Application
     {
     public:
         Application() = default;
-        explicit Application(std::vector<UWidget*> widgetsRef, void* userPointer, const std::function<void(Application&)>& begin = [](Application&) -> void {}, uint32_t tickPeriod = 0) noexcept;
+        explicit Application(std::vector<UWidget*> widgetsRef, void* userPointer, const std::function<void(Application&)>& begin = [](Application&) -> void {}, uint32_t tickPeriod = 0, size_t arenaSize = 0) noexcept;
 
         // Self-referential: run() stores `this` into every widget, the view dispatcher's
         // event-callback context, and the scene manager context. A copy would leave those
@@ -142,10 +942,13 @@ namespace UFZ
         ~Application() noexcept;
 
         // Single-use: call run() (or the constructor that forwards to it) exactly once per
-        // Application instance. The harvested callback vectors are appended to, not reset, so a
-        // second run() would leave the SceneManagerHandlers pointing at the previous run's stale
-        // callbacks. Create a fresh Application instead of reusing one.
-        void run(std::vector<UWidget*> widgetsRef, void* userPointer, const std::function<void(Application&)>& begin = [](Application&) -> void {}, uint32_t tickPeriod = 0) noexcept;
+        // Application instance. The harvested callback tables live in the arena, which is only
+        // released by destroy(), so a second run() would allocate a second arena over the first.
+        // Create a fresh Application instead of reusing one.
+        //
+        // arenaSize is the number of bytes reserved in the arena for the application's own use on
+        // top of what the wrapper needs for itself.
+        void run(std::vector<UWidget*> widgetsRef, void* userPointer, const std::function<void(Application&)>& begin = [](Application&) -> void {}, uint32_t tickPeriod = 0, size_t arenaSize = 0) noexcept;
 
         template<typename T>
         T* getWidget(const size_t i) noexcept
@@ -157,15 +960,41 @@ namespace UFZ
         [[nodiscard]] const ViewDispatcher& getViewDispatcher() const noexcept;
         [[nodiscard]] const SceneManager& getSceneManager() const noexcept;
         [[nodiscard]] const Filesystem& getFilesystem() const noexcept;
+        [[nodiscard]] EventQueue& getEventQueue() noexcept;
+        [[nodiscard]] TimerService& getTimers() noexcept;
+        [[nodiscard]] BackgroundWorker& getWorker() noexcept;
+
+        // Runs job on the application's worker thread, see BackgroundWorker. Returns false if a job is already running.
+        bool runInBackground(const std::function<void()>& job, const std::function<void()>& onDone, uint32_t loadingScene, uint32_t loadingDelay = 250) noexcept;
+        [[nodiscard]] Arena& getArena() noexcept;
+#ifdef UFZ_MEMORY_PROFILING
+        [[nodiscard]] MemoryProfiler& getMemoryProfiler() noexcept;
+#endif
+#ifdef UFZ_LATENCY_PROFILING
+        [[nodiscard]] LatencyProfiler& getLatencyProfiler() noexcept;
+#endif
 
         [[nodiscard]] void* getUserPointer() const noexcept;
 
         void destroy() noexcept;
     private:
         friend class ViewDispatcher;
+        friend class EventQueue;
+        friend class TimerService;
+        friend class BackgroundWorker;
 
         SceneManager sceneManager;
         ViewDispatcher viewDispatcher;
+        EventQueue eventQueue;
+        TimerService timers;
+        BackgroundWorker worker;
+        Arena arena;
+#ifdef UFZ_MEMORY_PROFILING
+        MemoryProfiler memoryProfiler;
+#endif
+#ifdef UFZ_LATENCY_PROFILING
+        LatencyProfiler latencyProfiler;
+#endif
         Gui* gui = nullptr;
 
         Filesystem filesystem{};
@@ -173,9 +1002,9 @@ namespace UFZ
         void* ctx = nullptr;
         size_t tickInterval = 0;
 
-        std::vector<AppSceneOnEnterCallback> enterCallbacks{};
-        std::vector<AppSceneOnEventCallback> eventCallbacks{};
-        std::vector<AppSceneOnExitCallback> exitCallbacks{};
+        AppSceneOnEnterCallback* enterCallbacks = nullptr;
+        AppSceneOnEventCallback* eventCallbacks = nullptr;
+        AppSceneOnExitCallback* exitCallbacks = nullptr;
 
         SceneManagerHandlers handlers{};
 
@@ -183,6 +1012,38 @@ namespace UFZ
 
         bool bDestroyed = false;
 
+#ifdef UFZ_SCENE_HOOKS
+        // The scene manager passes no scene id to its callbacks, so each scene gets a trampoline of its own that knows
+        // its id, runs the instrumentation and then forwards to the widget's callback. Scenes past maxHookedScenes
+        // keep their own callbacks and are not profiled.
+        static constexpr size_t maxHookedScenes = 32;
+
+        // What the scene manager calls, the trampolines followed by the callbacks of any unhooked scenes
+        AppSceneOnEnterCallback* hookedEnterCallbacks = nullptr;
+        AppSceneOnEventCallback* hookedEventCallbacks = nullptr;
+        AppSceneOnExitCallback* hookedExitCallbacks = nullptr;
+
+        template<size_t id>
+        static void enterHook(void* context) noexcept;
+        template<size_t id>
+        static bool eventHook(void* context, SceneManagerEvent event) noexcept;
+        template<size_t id>
+        static void exitHook(void* context) noexcept;
+
+        struct Hooks
+        {
+            AppSceneOnEnterCallback enter[maxHookedScenes];
+            AppSceneOnEventCallback event[maxHookedScenes];
+            AppSceneOnExitCallback exit[maxHookedScenes];
+        };
+
+        template<size_t... ids>
+        static constexpr Hooks makeHooks(std::index_sequence<ids...>) noexcept
+        {
+            return Hooks{ { &enterHook<ids>... }, { &eventHook<ids>... }, { &exitHook<ids>... } };
+        }
+#endif
+
         void initSceneManager() noexcept;
         void initViewDispatcher() noexcept;
         void initGUI() noexcept;
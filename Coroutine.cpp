@@ -0,0 +1,258 @@
+#include "Coroutine.hpp"
+
+#define TAG "UFZ"
+
+// Arena handed to the next frame allocation. Set by CoroutineSceneState::start right before calling the body, which
+// allocates its frame before running any of its code, so the pointer is consumed immediately.
+static void* nextArena = nullptr;
+static size_t nextArenaSize = 0;
+
+// =====================================================================================================================
+// ===================================================== Scene task ====================================================
+// =====================================================================================================================
+
+UFZ::SceneTask UFZ::SceneTask::promise_type::get_return_object() noexcept
+{
+    return SceneTask(Handle::from_promise(*this));
+}
+
+UFZ::SceneTask UFZ::SceneTask::promise_type::get_return_object_on_allocation_failure() noexcept
+{
+    return SceneTask{};
+}
+
+void* UFZ::SceneTask::promise_type::operator new(const size_t size) noexcept
+{
+    void* result = nullptr;
+    if (nextArena != nullptr && size <= nextArenaSize)
+        result = nextArena;
+    else
+        FURI_LOG_E(TAG, "Coroutine frame of %zu bytes does not fit in a %zu byte arena", size, nextArenaSize);
+
+    nextArena = nullptr;
+    nextArenaSize = 0;
+    return result;
+}
+
+// The arena is static storage owned by the CoroutineScene, there is nothing to release
+void UFZ::SceneTask::promise_type::operator delete(void* ptr, const size_t size) noexcept
+{
+    UNUSED(ptr);
+    UNUSED(size);
+}
+
+UFZ::SceneTask::SceneTask(const Handle h) noexcept
+{
+    handle = h;
+}
+
+UFZ::SceneTask::SceneTask(SceneTask&& other) noexcept
+{
+    handle = other.handle;
+    other.handle = {};
+}
+
+UFZ::SceneTask& UFZ::SceneTask::operator=(SceneTask&& other) noexcept
+{
+    if (this != &other)
+    {
+        destroy();
+        handle = other.handle;
+        other.handle = {};
+    }
+    return *this;
+}
+
+bool UFZ::SceneTask::valid() const noexcept
+{
+    return static_cast<bool>(handle);
+}
+
+bool UFZ::SceneTask::done() const noexcept
+{
+    return !handle || handle.done();
+}
+
+void UFZ::SceneTask::destroy() noexcept
+{
+    if (handle)
+    {
+        auto& promise = handle.promise();
+        if (promise.wait == Wait::Sleep && promise.application != nullptr)
+            UNUSED(promise.application->getTimers().stop(promise.timer));
+        handle.destroy();
+        handle = {};
+    }
+}
+
+UFZ::SceneTask::~SceneTask() noexcept
+{
+    destroy();
+}
+
+// =====================================================================================================================
+// ===================================================== Awaiters ======================================================
+// =====================================================================================================================
+
+void UFZ::EventAwaiter::await_suspend(const SceneTask::Handle h) noexcept
+{
+    promise = &h.promise();
+    promise->wait = wait;
+    promise->awaitedEvent = event;
+}
+
+uint32_t UFZ::EventAwaiter::await_resume() const noexcept
+{
+    return promise != nullptr ? promise->receivedEvent : event;
+}
+
+UFZ::EventAwaiter UFZ::nextEvent() noexcept
+{
+    return EventAwaiter{ SceneTask::Wait::AnyEvent, 0 };
+}
+
+UFZ::EventAwaiter UFZ::nextEvent(const uint32_t id) noexcept
+{
+    return EventAwaiter{ SceneTask::Wait::Event, id };
+}
+
+bool UFZ::SleepAwaiter::await_suspend(const SceneTask::Handle h) const noexcept
+{
+    auto& promise = h.promise();
+    promise.timer = promise.application->getTimers().start(SceneTask::sleepEvent, milliseconds);
+    if (promise.timer == 0)
+    {
+        // Out of timers: carry on rather than suspending forever
+        FURI_LOG_E(TAG, "No free timer for a coroutine sleep");
+        return false;
+    }
+    promise.wait = SceneTask::Wait::Sleep;
+    return true;
+}
+
+UFZ::SleepAwaiter UFZ::sleep(const uint32_t milliseconds) noexcept
+{
+    return SleepAwaiter{ milliseconds };
+}
+
+// =====================================================================================================================
+// ===================================================== Completion ====================================================
+// =====================================================================================================================
+
+UFZ::Completion::Completion(const Application& app) noexcept
+{
+    application = &app;
+}
+
+void UFZ::Completion::signal(const int32_t value) noexcept
+{
+    result.store(value, std::memory_order_relaxed);
+    bDone.store(true, std::memory_order_release);
+    application->getViewDispatcher().sendCustomEvent(SceneTask::resumeEvent);
+}
+
+void UFZ::Completion::reset() noexcept
+{
+    bDone.store(false, std::memory_order_relaxed);
+}
+
+bool UFZ::Completion::await_ready() const noexcept
+{
+    return bDone.load(std::memory_order_acquire);
+}
+
+void UFZ::Completion::await_suspend(const SceneTask::Handle h) const noexcept
+{
+    auto& promise = h.promise();
+    promise.wait = SceneTask::Wait::Completion;
+    promise.completion = this;
+}
+
+int32_t UFZ::Completion::await_resume() const noexcept
+{
+    return result.load(std::memory_order_relaxed);
+}
+
+// =====================================================================================================================
+// =================================================== Scene driver ====================================================
+// =====================================================================================================================
+
+void UFZ::CoroutineSceneState::start(Application& app, SceneTask (*body)(Application&), void* arena, const size_t arenaSize) noexcept
+{
+    task = SceneTask{};
+    bStopRequested = false;
+
+    nextArena = arena;
+    nextArenaSize = arenaSize;
+
+    // With initial_suspend returning suspend_never the body already runs up to its first co_await in here
+    bRunning = true;
+    task = body(app);
+    bRunning = false;
+
+    if (!task.valid())
+        return;
+
+    if (bStopRequested)
+    {
+        task = SceneTask{};
+        bStopRequested = false;
+    }
+}
+
+bool UFZ::CoroutineSceneState::event(const SceneManagerEvent& event) noexcept
+{
+    if (task.done() || event.type != SceneManagerEventTypeCustom)
+        return false;
+
+    auto& promise = task.handle.promise();
+    switch (promise.wait)
+    {
+    case SceneTask::Wait::Sleep:
+        if (event.event != SceneTask::sleepEvent)
+            return false;
+        break;
+    case SceneTask::Wait::Completion:
+        if (event.event != SceneTask::resumeEvent || !static_cast<const Completion*>(promise.completion)->await_ready())
+            return false;
+        break;
+    case SceneTask::Wait::Event:
+        if (event.event != promise.awaitedEvent)
+            return false;
+        break;
+    case SceneTask::Wait::AnyEvent:
+        if (event.event == SceneTask::sleepEvent || event.event == SceneTask::resumeEvent)
+            return false;
+        break;
+    default:
+        return false;
+    }
+
+    promise.receivedEvent = event.event;
+    resume();
+    return true;
+}
+
+void UFZ::CoroutineSceneState::stop() noexcept
+{
+    if (bRunning)
+        bStopRequested = true;
+    else
+        task = SceneTask{};
+}
+
+void UFZ::CoroutineSceneState::resume() noexcept
+{
+    auto& promise = task.handle.promise();
+    promise.wait = SceneTask::Wait::None;
+
+    bRunning = true;
+    task.handle.resume();
+    bRunning = false;
+
+    if (bStopRequested)
+    {
+        task = SceneTask{};
+        bStopRequested = false;
+    }
+}
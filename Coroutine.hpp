@@ -0,0 +1,200 @@
+#pragma once
+#include "Common.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+
+namespace UFZ
+{
+    // Return type of a coroutine scene body. A body is a free function taking the application, for example:
+    //
+    // UFZ::SceneTask scanFlow(UFZ::Application& app)
+    // {
+    //     RENDER_VIEW(&app, ScanView);
+    //     const uint32_t event = co_await UFZ::nextEvent();
+    //     co_await UFZ::sleep(500);
+    //     ...
+    // }
+    //
+    // Frames never touch the general heap, they are placed in the fixed arena of the CoroutineScene running the body.
+    class SceneTask
+    {
+    public:
+        // Reserved custom event ids used to resume a suspended body, do not use them for your own events
+        static constexpr uint32_t sleepEvent = UINT32_MAX - 2;
+        static constexpr uint32_t resumeEvent = UINT32_MAX - 3;
+
+        enum class Wait : uint8_t
+        {
+            None,
+            Event,
+            AnyEvent,
+            Sleep,
+            Completion
+        };
+
+        struct promise_type
+        {
+            Application* application = nullptr;
+
+            Wait wait = Wait::None;
+            uint32_t awaitedEvent = 0;
+            uint32_t receivedEvent = 0;
+            uint32_t timer = 0;
+            const void* completion = nullptr;
+
+            // Receives the body's own argument, so awaiters can reach the application before the first suspension
+            explicit promise_type(Application& app) noexcept : application(&app) {}
+
+            SceneTask get_return_object() noexcept;
+            static SceneTask get_return_object_on_allocation_failure() noexcept;
+
+            // The body runs synchronously inside the scene's enter callback until its first co_await
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { furi_crash("Unhandled exception in a coroutine scene"); }
+
+            static void* operator new(size_t size) noexcept;
+            static void operator delete(void* ptr, size_t size) noexcept;
+        };
+
+        using Handle = std::coroutine_handle<promise_type>;
+
+        SceneTask() = default;
+        explicit SceneTask(Handle h) noexcept;
+
+        // Owns the coroutine frame
+        SceneTask(const SceneTask&) = delete;
+        SceneTask& operator=(const SceneTask&) = delete;
+        SceneTask(SceneTask&& other) noexcept;
+        SceneTask& operator=(SceneTask&& other) noexcept;
+
+        [[nodiscard]] bool valid() const noexcept;
+        [[nodiscard]] bool done() const noexcept;
+
+        ~SceneTask() noexcept;
+    private:
+        friend class CoroutineSceneState;
+
+        Handle handle{};
+
+        void destroy() noexcept;
+    };
+
+    // Awaiting it suspends the body until a custom event reaches the scene, and evaluates to the event id
+    struct EventAwaiter
+    {
+        SceneTask::Wait wait;
+        uint32_t event;
+        SceneTask::promise_type* promise = nullptr;
+
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+        void await_suspend(SceneTask::Handle h) noexcept;
+        [[nodiscard]] uint32_t await_resume() const noexcept;
+    };
+
+    // Suspends until any custom event arrives
+    [[nodiscard]] EventAwaiter nextEvent() noexcept;
+
+    // Suspends until the custom event id arrives, other custom events are left to the scene manager's default
+    // handling
+    [[nodiscard]] EventAwaiter nextEvent(uint32_t id) noexcept;
+
+    // Suspends the body for at least milliseconds using the application's TimerService
+    struct SleepAwaiter
+    {
+        uint32_t milliseconds;
+
+        [[nodiscard]] bool await_ready() const noexcept { return milliseconds == 0; }
+        bool await_suspend(SceneTask::Handle h) const noexcept;
+        void await_resume() const noexcept {}
+    };
+
+    [[nodiscard]] SleepAwaiter sleep(uint32_t milliseconds) noexcept;
+
+    // Bridges a worker thread and a coroutine body. The worker calls signal() when its job, for example a storage
+    // operation, is done; the body that co_awaits the completion is then resumed on the GUI thread with the result.
+    // The completion must outlive the worker's use of it, so keep it outside the coroutine frame if the job may still
+    // be running when the scene exits.
+    class Completion
+    {
+    public:
+        explicit Completion(const Application& app) noexcept;
+
+        Completion(const Completion&) = delete;
+        Completion& operator=(const Completion&) = delete;
+
+        // Safe to call from any thread
+        void signal(int32_t result) noexcept;
+
+        // Allows awaiting the same completion again for the next job
+        void reset() noexcept;
+
+        [[nodiscard]] bool await_ready() const noexcept;
+        void await_suspend(SceneTask::Handle h) const noexcept;
+        [[nodiscard]] int32_t await_resume() const noexcept;
+    private:
+        friend class CoroutineSceneState;
+
+        const Application* application = nullptr;
+        std::atomic<int32_t> result = 0;
+        std::atomic<bool> bDone = false;
+    };
+
+    // Drives one scene body on behalf of a CoroutineScene. Resumes it from the scene's custom events and destroys it
+    // when the scene exits.
+    class CoroutineSceneState
+    {
+    public:
+        CoroutineSceneState() = default;
+
+        void start(Application& app, SceneTask (*body)(Application&), void* arena, size_t arenaSize) noexcept;
+        bool event(const SceneManagerEvent& event) noexcept;
+        void stop() noexcept;
+    private:
+        SceneTask task{};
+
+        // The body may leave the scene while it runs, which calls stop() from inside resume(). The frame can not be
+        // destroyed then, so destruction is deferred until the body suspends again.
+        bool bRunning = false;
+        bool bStopRequested = false;
+
+        void resume() noexcept;
+    };
+
+    // Generates the enter, event and exit callbacks of a scene that runs body as a coroutine. Pass them to a widget
+    // like any other scene callbacks:
+    //
+    // UFZ::Submenu menu(UFZ::CoroutineScene<scanFlow>::enter, UFZ::CoroutineScene<scanFlow>::event, UFZ::CoroutineScene<scanFlow>::exit);
+    //
+    // The body's frame lives in a static arena of arenaSize bytes; entering the scene fails with an error log if the
+    // frame does not fit.
+    template<SceneTask (*body)(Application&), size_t arenaSize = 1024>
+    class CoroutineScene
+    {
+    public:
+        static void enter(void* context) noexcept
+        {
+            furi_assert(context);
+            state.start(*static_cast<Application*>(context), body, arena, arenaSize);
+        }
+
+        static bool event(void* context, const SceneManagerEvent event) noexcept
+        {
+            UNUSED(context);
+            return state.event(event);
+        }
+
+        static void exit(void* context) noexcept
+        {
+            UNUSED(context);
+            state.stop();
+        }
+    private:
+        alignas(std::max_align_t) static inline uint8_t arena[arenaSize]{};
+        static inline CoroutineSceneState state{};
+    };
+}
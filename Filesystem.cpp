@@ -7,6 +7,7 @@
 void UFZ::Filesystem::init() noexcept
 {
     storage = static_cast<Storage*>(furi_record_open(RECORD_STORAGE));
+    indicesMutex = furi_mutex_alloc(FuriMutexTypeNormal);
 }
 
 FS_Error UFZ::Filesystem::timestamp(const char* path, uint32_t* timestamp) const noexcept
@@ -26,32 +27,56 @@ bool UFZ::Filesystem::exists(const char* path) const noexcept
 
 FS_Error UFZ::Filesystem::remove(const char* path) const noexcept
 {
-    return storage_common_remove(storage, path);
+    const FS_Error result = storage_common_remove(storage, path);
+    if (result == FSE_OK)
+        notifyRemoved(path);
+    return result;
 }
 
 FS_Error UFZ::Filesystem::rename(const char* oldPath, const char* newPath) const noexcept
 {
-    return storage_common_rename(storage, oldPath, newPath);
+    const FS_Error result = storage_common_rename(storage, oldPath, newPath);
+    if (result == FSE_OK)
+    {
+        notifyRemoved(oldPath);
+        notifyCreated(newPath);
+    }
+    return result;
 }
 
 FS_Error UFZ::Filesystem::copy(const char* oldPath, const char* newPath) const noexcept
 {
-    return storage_common_copy(storage, oldPath, newPath);
+    const FS_Error result = storage_common_copy(storage, oldPath, newPath);
+    if (result == FSE_OK)
+        notifyCreated(newPath);
+    return result;
 }
 
 FS_Error UFZ::Filesystem::merge(const char* oldPath, const char* newPath) const noexcept
 {
-    return storage_common_merge(storage, oldPath, newPath);
+    const FS_Error result = storage_common_merge(storage, oldPath, newPath);
+    if (result == FSE_OK)
+        notifyCreated(newPath);
+    return result;
 }
 
 FS_Error UFZ::Filesystem::migrate(const char* source, const char* destination) const noexcept
 {
-    return storage_common_migrate(storage, source, destination);
+    const FS_Error result = storage_common_migrate(storage, source, destination);
+    if (result == FSE_OK)
+    {
+        notifyRemoved(source);
+        notifyCreated(destination);
+    }
+    return result;
 }
 
 FS_Error UFZ::Filesystem::mkdir(const char* path) const noexcept
 {
-    return storage_common_mkdir(storage, path);
+    const FS_Error result = storage_common_mkdir(storage, path);
+    if (result == FSE_OK)
+        notifyCreated(path);
+    return result;
 }
 
 FS_Error UFZ::Filesystem::filesystemInfo(const char* path, uint64_t* totalSpace, uint64_t* freeSpace) const noexcept
@@ -59,6 +84,13 @@ FS_Error UFZ::Filesystem::filesystemInfo(const char* path, uint64_t* totalSpace,
     return storage_common_fs_info(storage, path, totalSpace, freeSpace);
 }
 
+bool UFZ::Filesystem::hasFreeSpace(const char* path, const uint64_t bytes) const noexcept
+{
+    uint64_t total = 0;
+    uint64_t free = 0;
+    return filesystemInfo(path, &total, &free) == FSE_OK && free >= bytes;
+}
+
 void UFZ::Filesystem::resolvePathAndEnsureAppDirectory(FuriString* path) const noexcept
 {
     storage_common_resolve_path_and_ensure_app_directory(storage, path);
@@ -86,17 +118,26 @@ FS_Error UFZ::Filesystem::SDCardStatus() const noexcept
 
 bool UFZ::Filesystem::removeSimple(const char* path) const noexcept
 {
-    return storage_simply_remove(storage, path);
+    const bool bResult = storage_simply_remove(storage, path);
+    if (bResult)
+        notifyRemoved(path);
+    return bResult;
 }
 
 bool UFZ::Filesystem::removeRecursiveSimple(const char* path) const noexcept
 {
-    return storage_simply_remove_recursive(storage, path);
+    const bool bResult = storage_simply_remove_recursive(storage, path);
+    if (bResult)
+        notifyRemoved(path);
+    return bResult;
 }
 
 bool UFZ::Filesystem::mkdirSimple(const char* path) const noexcept
 {
-    return storage_simply_mkdir(storage, path);
+    const bool bResult = storage_simply_mkdir(storage, path);
+    if (bResult)
+        notifyCreated(path);
+    return bResult;
 }
 
 void UFZ::Filesystem::getNextFilename(const char* dirname, const char* filename, const char* fileExtension, FuriString* nextFilename, const uint8_t maxLength) const noexcept
@@ -104,19 +145,145 @@ void UFZ::Filesystem::getNextFilename(const char* dirname, const char* filename,
     storage_get_next_filename(storage, dirname, filename, fileExtension, nextFilename, maxLength);
 }
 
+void UFZ::Filesystem::run(FilesystemBatch& batch) const noexcept
+{
+    batch.failures = 0;
+    for (size_t i = 0; i < batch.operations.size(); i++)
+    {
+        const auto& operation = batch.operations[i];
+        const char* path = &batch.paths[operation.path];
+
+        FS_Error result;
+        switch (operation.type)
+        {
+        case FilesystemBatch::Type::Remove:
+            result = remove(path);
+            break;
+        case FilesystemBatch::Type::Rename:
+            result = rename(path, &batch.paths[operation.newPath]);
+            break;
+        case FilesystemBatch::Type::Stat:
+            result = storage_common_stat(storage, path, &batch.infos[operation.info]);
+            break;
+        default:
+            result = FSE_INVALID_PARAMETER;
+            break;
+        }
+
+        batch.results[i] = result;
+        if (result != FSE_OK)
+            batch.failures++;
+    }
+}
+
+void UFZ::Filesystem::notifyCreated(const char* path) const noexcept
+{
+    furi_mutex_acquire(indicesMutex, FuriWaitForever);
+    for (FilenameIndex* index = filenameIndices; index != nullptr; index = index->nextIndex)
+        index->created(path);
+    furi_mutex_release(indicesMutex);
+}
+
+void UFZ::Filesystem::notifyRemoved(const char* path) const noexcept
+{
+    furi_mutex_acquire(indicesMutex, FuriWaitForever);
+    for (FilenameIndex* index = filenameIndices; index != nullptr; index = index->nextIndex)
+        index->removed(path);
+    furi_mutex_release(indicesMutex);
+}
+
 void UFZ::Filesystem::destroy() noexcept
 {
+    // Indices held in the application's own state outlive it, detach them so their free() does not touch this
+    if (indicesMutex != nullptr)
+    {
+        furi_mutex_acquire(indicesMutex, FuriWaitForever);
+        while (filenameIndices != nullptr)
+        {
+            FilenameIndex* index = filenameIndices;
+            furi_mutex_acquire(index->mutex, FuriWaitForever);
+            filenameIndices = index->nextIndex;
+            index->storage = nullptr;
+            index->nextIndex = nullptr;
+            furi_mutex_release(index->mutex);
+        }
+        furi_mutex_release(indicesMutex);
+    }
+
     if (storage != nullptr)
     {
         furi_record_close(RECORD_STORAGE);
         storage = nullptr;
     }
+    FREE_GUARD(furi_mutex_free, indicesMutex);
 }
 
 // =====================================================================================================================
 // ======================================================= Files =======================================================
 // =====================================================================================================================
 
+// A bounded buffer of chunks between the read-ahead thread and the reader, counted by two semaphores. A chunk shorter
+// than chunkSize is the last one, the thread stops after reading it.
+struct UFZ::File::ReadAhead
+{
+    struct Chunk
+    {
+        uint8_t* data;
+        size_t length;
+    };
+
+    ::File* file = nullptr;
+    FuriThread* thread = nullptr;
+    FuriSemaphore* filled = nullptr;
+    FuriSemaphore* empty = nullptr;
+
+    uint8_t* memory = nullptr;
+    Chunk chunks[maxReadAheadChunks]{};
+    size_t chunkSize = 0;
+    size_t chunkCount = 0;
+    std::atomic<bool> bStop = false;
+
+    // Thread side
+    size_t produced = 0;
+
+    // Reader side
+    size_t consumed = 0;
+    size_t offset = 0;
+    uint64_t position = 0;
+    bool bHolding = false;
+    bool bEof = false;
+
+    size_t read(uint8_t* buffer, const size_t size) noexcept
+    {
+        size_t done = 0;
+        while (done < size && !bEof)
+        {
+            if (!bHolding)
+            {
+                furi_check(furi_semaphore_acquire(filled, FuriWaitForever) == FuriStatusOk);
+                bHolding = true;
+                offset = 0;
+            }
+
+            const Chunk& chunk = chunks[consumed];
+            const size_t n = size - done < chunk.length - offset ? size - done : chunk.length - offset;
+            memcpy(buffer + done, chunk.data + offset, n);
+            offset += n;
+            done += n;
+
+            if (offset == chunk.length)
+            {
+                bEof = chunk.length < chunkSize;
+                bHolding = false;
+                consumed = (consumed + 1) % chunkCount;
+                furi_semaphore_release(empty);
+            }
+        }
+        position += done;
+        return done;
+    }
+};
+
 UFZ::File::File(const UFZ::Filesystem& store) noexcept
 {
     storage = const_cast<Filesystem*>(&store);
@@ -130,10 +297,14 @@ UFZ::File::File(const UFZ::Filesystem& store, const char* path, const FS_AccessM
 bool UFZ::File::open(const UFZ::Filesystem& store, const char* path, const FS_AccessMode accessMode, const FS_OpenMode openMode) noexcept
 {
     // Release any handle from a previous open() so re-opening does not leak it.
+    disableReadAhead();
     free();
     storage = const_cast<Filesystem*>(&store);
     init();
-    return storage_file_open(file, path, accessMode, openMode);
+    const bool bResult = storage_file_open(file, path, accessMode, openMode);
+    if (bResult && openMode != FSOM_OPEN_EXISTING)
+        storage->notifyCreated(path);
+    return bResult;
 }
 
 bool UFZ::File::isOpen() const noexcept
@@ -148,22 +319,51 @@ bool UFZ::File::isDirectory() const noexcept
 
 size_t UFZ::File::read(void* buffer, const size_t bytesToRead) const noexcept
 {
-    return storage_file_read(file, buffer, bytesToRead);
+    if (readAhead != nullptr)
+        return readAhead->read(static_cast<uint8_t*>(buffer), bytesToRead);
+
+    const size_t bytesRead = storage_file_read(file, buffer, bytesToRead);
+    if (bPreallocated)
+        position += bytesRead;
+    return bytesRead;
 }
 
 size_t UFZ::File::write(const void* buffer, const size_t bytesToWrite) const noexcept
 {
-    return storage_file_write(file, buffer, bytesToWrite);
+    const size_t written = storage_file_write(file, buffer, bytesToWrite);
+    if (bPreallocated)
+    {
+        position += written;
+        if (position > dataEnd)
+            dataEnd = position;
+    }
+    return written;
 }
 
 uint64_t UFZ::File::tell() const noexcept
 {
+    if (readAhead != nullptr)
+        return readAhead->position;
     return storage_file_tell(file);
 }
 
 bool UFZ::File::seek(const uint32_t offset, const bool bFromStart) const noexcept
 {
-    return storage_file_seek(file, offset, bFromStart);
+    if (readAhead != nullptr)
+    {
+        const uint64_t target = bFromStart ? offset : readAhead->position + offset;
+        if (target == readAhead->position)
+            return true;
+
+        // Not sequential any more, the thread's position is ahead of ours so continue from an absolute one
+        stopReadAhead();
+        return storage_file_seek(file, static_cast<uint32_t>(target), true);
+    }
+
+    const bool bResult = storage_file_seek(file, offset, bFromStart);
+    if (bPreallocated)
+        position = bResult ? (bFromStart ? offset : position + offset) : storage_file_tell(file);
+    return bResult;
 }
 
 bool UFZ::File::truncate() const noexcept
@@ -183,16 +383,37 @@ bool UFZ::File::sync() const noexcept
 
 bool UFZ::File::eof() const noexcept
 {
+    if (readAhead != nullptr)
+        return readAhead->bEof;
     return storage_file_eof(file);
 }
 
+bool UFZ::File::preallocate(const uint64_t bytes) noexcept
+{
+    if (file == nullptr || storage_file_size(file) != 0 || !storage_file_expand(file, bytes))
+        return false;
+
+    bPreallocated = true;
+    dataEnd = 0;
+    position = 0;
+    return true;
+}
+
 bool UFZ::File::copyToFile(const File& source, const File& destination, const size_t size) noexcept
 {
-    return storage_file_copy_to_file(source.file, destination.file, size);
+    const bool bResult = storage_file_copy_to_file(source.file, destination.file, size);
+    if (destination.bPreallocated)
+    {
+        destination.position = bResult ? destination.position + size : storage_file_tell(destination.file);
+        if (destination.position > destination.dataEnd)
+            destination.dataEnd = destination.position;
+    }
+    return bResult;
 }
 
 void UFZ::File::close() noexcept
 {
+    disableReadAhead();
     // Guard against a never-opened or already-closed File: storage_file_close(nullptr)
     // trips furi_check. free() nulls the handle, so a second close() is a no-op.
     if (file != nullptr)
@@ -202,7 +423,12 @@ void UFZ::File::close() noexcept
         if (bDirectory)
             storage_dir_close(file);
         else
+        {
+            // Give back the part of the preallocation that was never written
+            if (bPreallocated && storage_file_seek(file, static_cast<uint32_t>(dataEnd), true))
+                UNUSED(storage_file_truncate(file));
             storage_file_close(file);
+        }
         free();
     }
 }
@@ -221,6 +447,91 @@ void UFZ::File::free() noexcept
 {
     FREE_GUARD(storage_file_free, file);
     bDirectory = false;
+    bPreallocated = false;
+    dataEnd = 0;
+    position = 0;
+}
+
+// =====================================================================================================================
+// ===================================================== Read-ahead ====================================================
+// =====================================================================================================================
+
+bool UFZ::File::enableReadAhead(const size_t chunkSize, const size_t chunkCount, const uint32_t stackSize) noexcept
+{
+    disableReadAhead();
+    if (file == nullptr || chunkSize == 0 || chunkCount == 0 || chunkCount > maxReadAheadChunks)
+        return false;
+
+    auto* state = new ReadAhead();
+    state->memory = static_cast<uint8_t*>(malloc(chunkSize * chunkCount));
+    if (state->memory == nullptr)
+    {
+        delete state;
+        return false;
+    }
+
+    state->file = file;
+    state->chunkSize = chunkSize;
+    state->chunkCount = chunkCount;
+    state->position = storage_file_tell(file);
+    for (size_t i = 0; i < chunkCount; i++)
+        state->chunks[i].data = state->memory + i * chunkSize;
+
+    state->filled = furi_semaphore_alloc(chunkCount, 0);
+    state->empty = furi_semaphore_alloc(chunkCount, chunkCount);
+    state->thread = furi_thread_alloc_ex("UFZReadAhead", stackSize, [](void* context) -> int32_t
+    {
+        auto* self = static_cast<ReadAhead*>(context);
+        while (true)
+        {
+            furi_check(furi_semaphore_acquire(self->empty, FuriWaitForever) == FuriStatusOk);
+            if (self->bStop.load(std::memory_order_acquire))
+                return 0;
+
+            ReadAhead::Chunk& chunk = self->chunks[self->produced];
+            chunk.length = storage_file_read(self->file, chunk.data, self->chunkSize);
+            self->produced = (self->produced + 1) % self->chunkCount;
+            furi_semaphore_release(self->filled);
+
+            if (chunk.length < self->chunkSize)
+                return 0;
+        }
+    }, state);
+
+    readAhead = state;
+    furi_thread_start(state->thread);
+    return true;
+}
+
+void UFZ::File::disableReadAhead() noexcept
+{
+    stopReadAhead();
+}
+
+void UFZ::File::stopReadAhead() const noexcept
+{
+    if (readAhead == nullptr)
+        return;
+
+    // The thread is either waiting for an empty chunk or reading into one, wake it up in case it is waiting
+    readAhead->bStop.store(true, std::memory_order_release);
+    furi_semaphore_release(readAhead->empty);
+    furi_thread_join(readAhead->thread);
+    furi_thread_free(readAhead->thread);
+
+    // Put the handle back where the reader is, the thread has read further
+    UNUSED(storage_file_seek(file, static_cast<uint32_t>(readAhead->position), true));
+
+    furi_semaphore_free(readAhead->filled);
+    furi_semaphore_free(readAhead->empty);
+    ::free(readAhead->memory);
+    delete readAhead;
+    readAhead = nullptr;
+}
+
+bool UFZ::File::isReadAheadEnabled() const noexcept
+{
+    return readAhead != nullptr;
 }
 
 // =====================================================================================================================
@@ -235,6 +546,9 @@ UFZ::Directory::Directory(File& f) noexcept
 bool UFZ::Directory::open(UFZ::File& f, const char* path) noexcept
 {
     file = &f;
+    // A File constructed from just the filesystem has no handle yet
+    if (file->file == nullptr)
+        file->init();
     // Mark the File as a directory so its teardown (here or in ~File) closes it as one.
     file->bDirectory = true;
     return storage_dir_open(file->file, path);
@@ -264,3 +578,785 @@ bool UFZ::Directory::rewind() const noexcept
         return false;
     return storage_dir_rewind(file->file);
 }
+
+// =====================================================================================================================
+// ==================================================== Capture sink ===================================================
+// =====================================================================================================================
+
+bool UFZ::CaptureSink::open(const Filesystem& filesystem, const char* path, const size_t size, const size_t count, const uint32_t syncInterval, const uint32_t stackSize) noexcept
+{
+    close();
+    if (size == 0 || count < 2 || count > maxBuffers)
+        return false;
+
+    memory = static_cast<uint8_t*>(malloc(size * count));
+    if (memory == nullptr)
+        return false;
+
+    if (!file.open(filesystem, path, FSAM_WRITE, FSOM_CREATE_ALWAYS))
+    {
+        file.close();
+        ::free(memory);
+        memory = nullptr;
+        return false;
+    }
+
+    bufferSize = size;
+    bufferCount = count;
+    syncTicks = syncInterval > 0 ? furi_ms_to_ticks(syncInterval) : 0;
+    for (size_t i = 0; i < maxBuffers; i++)
+    {
+        bReady[i] = false;
+        lengths[i] = 0;
+    }
+    filling = 0;
+    fill = 0;
+    bytesWritten = 0;
+    droppedBytes = 0;
+    overruns = 0;
+    writeTicks = 0;
+    longestWrite = 0;
+    syncs = 0;
+    bError = false;
+    openTick = furi_get_tick();
+
+    thread = furi_thread_alloc_ex("UFZCapture", stackSize, [](void* context) -> int32_t
+    {
+        auto* self = static_cast<CaptureSink*>(context);
+        size_t next = 0;
+        uint32_t lastSync = furi_get_tick();
+        uint32_t unsynced = 0;
+
+        while (true)
+        {
+            const uint32_t flags = furi_thread_flags_wait(readyFlag | exitFlag, FuriFlagWaitAny, self->syncTicks > 0 ? self->syncTicks : FuriWaitForever);
+            const uint32_t before = self->bytesWritten.load(std::memory_order_relaxed);
+            self->drain(next);
+            unsynced += self->bytesWritten.load(std::memory_order_relaxed) - before;
+
+            const bool bExit = (flags & FuriFlagError) == 0 && (flags & exitFlag) != 0;
+            if (unsynced > 0 && (bExit || (self->syncTicks > 0 && furi_get_tick() - lastSync >= self->syncTicks)))
+            {
+                if (!self->file.sync())
+                    self->bError = true;
+                self->syncs.fetch_add(1, std::memory_order_relaxed);
+                lastSync = furi_get_tick();
+                unsynced = 0;
+            }
+            if (bExit)
+                return 0;
+        }
+    }, this);
+    furi_thread_start(thread);
+    return true;
+}
+
+void UFZ::CaptureSink::close() noexcept
+{
+    if (thread != nullptr)
+    {
+        flush();
+
+        // The writer drains every ready buffer before it exits
+        furi_thread_flags_set(furi_thread_get_id(thread), exitFlag);
+        furi_thread_join(thread);
+        furi_thread_free(thread);
+        thread = nullptr;
+    }
+    file.close();
+    if (memory != nullptr)
+    {
+        ::free(memory);
+        memory = nullptr;
+    }
+    bufferCount = 0;
+}
+
+size_t UFZ::CaptureSink::write(const void* data, const size_t size) noexcept
+{
+    if (thread == nullptr)
+        return 0;
+
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    size_t accepted = 0;
+    while (accepted < size)
+    {
+        // The buffer we would fill next has not been written yet
+        if (bReady[filling].load(std::memory_order_acquire))
+        {
+            droppedBytes.fetch_add(static_cast<uint32_t>(size - accepted), std::memory_order_relaxed);
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+
+        const size_t n = size - accepted < bufferSize - fill ? size - accepted : bufferSize - fill;
+        memcpy(memory + filling * bufferSize + fill, bytes + accepted, n);
+        fill += n;
+        accepted += n;
+
+        if (fill == bufferSize)
+            submit();
+    }
+    return accepted;
+}
+
+void UFZ::CaptureSink::flush() noexcept
+{
+    if (thread != nullptr && fill > 0 && !bReady[filling].load(std::memory_order_acquire))
+        submit();
+}
+
+// Hands the buffer being filled to the writer and moves on to the next one
+void UFZ::CaptureSink::submit() noexcept
+{
+    lengths[filling] = fill;
+    bReady[filling].store(true, std::memory_order_release);
+    furi_thread_flags_set(furi_thread_get_id(thread), readyFlag);
+
+    filling = (filling + 1) % bufferCount;
+    fill = 0;
+}
+
+// Writer side, writes every ready buffer in the order they were filled
+void UFZ::CaptureSink::drain(size_t& next) noexcept
+{
+    while (bReady[next].load(std::memory_order_acquire))
+    {
+        const uint32_t start = furi_get_tick();
+        const size_t written = file.write(memory + next * bufferSize, lengths[next]);
+        const uint32_t elapsed = furi_get_tick() - start;
+
+        if (written != lengths[next])
+            bError = true;
+        bytesWritten.fetch_add(static_cast<uint32_t>(written), std::memory_order_relaxed);
+        writeTicks.fetch_add(elapsed, std::memory_order_relaxed);
+        if (elapsed > longestWrite.load(std::memory_order_relaxed))
+            longestWrite.store(elapsed, std::memory_order_relaxed);
+
+        bReady[next].store(false, std::memory_order_release);
+        next = (next + 1) % bufferCount;
+    }
+}
+
+UFZ::CaptureSink::Stats UFZ::CaptureSink::getStats() const noexcept
+{
+    const uint32_t frequency = furi_kernel_get_tick_frequency();
+    const uint32_t written = bytesWritten.load(std::memory_order_relaxed);
+    const uint32_t elapsed = furi_get_tick() - openTick;
+    const uint32_t busy = writeTicks.load(std::memory_order_relaxed);
+
+    return Stats{
+        .bytesWritten = written,
+        .droppedBytes = droppedBytes.load(std::memory_order_relaxed),
+        .overruns = overruns.load(std::memory_order_relaxed),
+        .averageRate = elapsed > 0 ? static_cast<uint32_t>(static_cast<uint64_t>(written) * frequency / elapsed) : 0,
+        .storageRate = busy > 0 ? static_cast<uint32_t>(static_cast<uint64_t>(written) * frequency / busy) : 0,
+        .longestWrite = static_cast<uint32_t>(static_cast<uint64_t>(longestWrite.load(std::memory_order_relaxed)) * 1000 / frequency),
+        .syncs = syncs.load(std::memory_order_relaxed),
+        .bError = bError.load(std::memory_order_relaxed),
+    };
+}
+
+bool UFZ::CaptureSink::isOpen() const noexcept
+{
+    return thread != nullptr;
+}
+
+UFZ::CaptureSink::~CaptureSink() noexcept
+{
+    close();
+}
+
+// =====================================================================================================================
+// ==================================================== Pack reader ====================================================
+// =====================================================================================================================
+
+bool UFZ::PackReader::open(const Filesystem& filesystem, const char* path) noexcept
+{
+    close();
+    if (!file.open(filesystem, path, FSAM_READ, FSOM_OPEN_EXISTING))
+    {
+        file.close();
+        return false;
+    }
+
+    Header header{};
+    const uint64_t fileSize = file.size();
+    if (file.read(&header, sizeof(header)) != sizeof(header) || header.magic != magic || header.version != version ||
+        sizeof(Header) + static_cast<uint64_t>(header.entryCount) * sizeof(Record) + header.namesSize > fileSize)
+    {
+        close();
+        return false;
+    }
+
+    records.resize(header.entryCount);
+    names.resize(header.namesSize + 1);
+    const size_t recordBytes = records.size() * sizeof(Record);
+    if (file.read(records.data(), recordBytes) != recordBytes || file.read(names.data(), header.namesSize) != header.namesSize)
+    {
+        close();
+        return false;
+    }
+
+    // A corrupt pack must not send name lookups or reads past what was loaded
+    names.back() = '\0';
+    for (const auto& a : records)
+    {
+        if (a.nameOffset >= header.namesSize || static_cast<uint64_t>(a.offset) + a.size > fileSize)
+        {
+            close();
+            return false;
+        }
+    }
+    filePosition = file.tell();
+    return true;
+}
+
+void UFZ::PackReader::close() noexcept
+{
+    file.close();
+    records.clear();
+    records.shrink_to_fit();
+    names.clear();
+    names.shrink_to_fit();
+    filePosition = 0;
+}
+
+UFZ::PackReader::Entry UFZ::PackReader::find(const char* name) noexcept
+{
+    const uint32_t key = hash(name);
+    size_t low = 0;
+    size_t high = records.size();
+    while (low < high)
+    {
+        const size_t middle = (low + high) / 2;
+        const Record& record = records[middle];
+        const int order = record.hash != key ? (record.hash < key ? -1 : 1) : strcmp(&names[record.nameOffset], name);
+        if (order == 0)
+        {
+            Entry entry;
+            entry.pack = this;
+            entry.offset = record.offset;
+            entry.length = record.size;
+            return entry;
+        }
+        if (order < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return {};
+}
+
+size_t UFZ::PackReader::size() const noexcept
+{
+    return records.size();
+}
+
+const char* UFZ::PackReader::getName(const size_t i) const noexcept
+{
+    return i < records.size() ? &names[records[i].nameOffset] : nullptr;
+}
+
+size_t UFZ::PackReader::readAt(const uint32_t offset, void* buffer, const size_t bytes) noexcept
+{
+    if (filePosition != offset)
+    {
+        if (!file.seek(offset, true))
+            return 0;
+        filePosition = offset;
+    }
+
+    const size_t read = file.read(buffer, bytes);
+    filePosition += read;
+    return read;
+}
+
+size_t UFZ::PackReader::Entry::read(void* buffer, const size_t bytesToRead) noexcept
+{
+    if (pack == nullptr)
+        return 0;
+
+    const size_t n = bytesToRead < length - position ? bytesToRead : length - position;
+    const size_t read = n > 0 ? pack->readAt(offset + position, buffer, n) : 0;
+    position += static_cast<uint32_t>(read);
+    return read;
+}
+
+size_t UFZ::PackReader::Entry::read(std::vector<uint8_t>& buffer) noexcept
+{
+    const size_t start = buffer.size();
+    buffer.resize(start + (length - position));
+    const size_t read = this->read(buffer.data() + start, length - position);
+    buffer.resize(start + read);
+    return read;
+}
+
+bool UFZ::PackReader::Entry::seek(const uint32_t target, const bool bFromStart) noexcept
+{
+    const uint64_t next = bFromStart ? target : static_cast<uint64_t>(position) + target;
+    if (pack == nullptr || next > length)
+        return false;
+    position = static_cast<uint32_t>(next);
+    return true;
+}
+
+uint64_t UFZ::PackReader::Entry::tell() const noexcept
+{
+    return position;
+}
+
+uint64_t UFZ::PackReader::Entry::size() const noexcept
+{
+    return length;
+}
+
+bool UFZ::PackReader::Entry::eof() const noexcept
+{
+    return position >= length;
+}
+
+bool UFZ::PackReader::Entry::isValid() const noexcept
+{
+    return pack != nullptr;
+}
+
+// =====================================================================================================================
+// ===================================================== Line index ====================================================
+// =====================================================================================================================
+
+bool UFZ::LineIndex::build(const File& file) noexcept
+{
+    clear();
+    sourceSize = file.size();
+    if (!file.seek(0, true))
+        return false;
+
+    char chunk[256];
+    Splitter splitter;
+    uint32_t offset = 0;
+    uint32_t lines = 0;
+    size_t bytes;
+
+    checkpoints.push_back(0);
+    while ((bytes = file.read(chunk, sizeof(chunk))) > 0)
+    {
+        for (size_t i = 0; i < bytes; i++)
+        {
+            offset++;
+            if (splitter.feed(chunk[i]) && ++lines % interval == 0)
+                checkpoints.push_back(offset);
+        }
+    }
+    lineCount = lines + (splitter.length > 0 ? 1 : 0);
+    checkpoints.shrink_to_fit();
+    return true;
+}
+
+bool UFZ::LineIndex::open(const Filesystem& filesystem, const char* sourcePath, const File& source, const char* indexPath) noexcept
+{
+    uint32_t timestamp = 0;
+    if (filesystem.timestamp(sourcePath, &timestamp) != FSE_OK)
+        return build(source);
+
+    if (load(filesystem, indexPath, source.size(), timestamp))
+        return true;
+
+    if (!build(source))
+        return false;
+    sourceTimestamp = timestamp;
+
+    // A stale or missing sidecar only costs the scan we just did, so failing to write one is not an error
+    UNUSED(save(filesystem, indexPath));
+    return true;
+}
+
+bool UFZ::LineIndex::load(const Filesystem& filesystem, const char* indexPath, const uint64_t size, const uint32_t timestamp) noexcept
+{
+    clear();
+    File file(filesystem, indexPath, FSAM_READ, FSOM_OPEN_EXISTING);
+    if (!file.isOpen())
+        return false;
+
+    Header header{};
+    if (file.read(&header, sizeof(header)) != sizeof(header) || header.magic != magic || header.version != version ||
+        header.interval != interval || header.maxLineLength != maxLineLength || header.sourceSize != size ||
+        header.sourceTimestamp != timestamp || file.size() != sizeof(header) + static_cast<uint64_t>(header.checkpointCount) * sizeof(uint32_t))
+        return false;
+
+    checkpoints.resize(header.checkpointCount);
+    const size_t bytes = checkpoints.size() * sizeof(uint32_t);
+    if (file.read(checkpoints.data(), bytes) != bytes)
+    {
+        clear();
+        return false;
+    }
+
+    sourceSize = header.sourceSize;
+    sourceTimestamp = header.sourceTimestamp;
+    lineCount = header.lineCount;
+    return true;
+}
+
+bool UFZ::LineIndex::save(const Filesystem& filesystem, const char* indexPath) const noexcept
+{
+    File file(filesystem, indexPath, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    if (!file.isOpen())
+        return false;
+
+    const Header header{
+        .magic = magic,
+        .version = version,
+        .interval = static_cast<uint16_t>(interval),
+        .maxLineLength = maxLineLength,
+        .sourceTimestamp = sourceTimestamp,
+        .sourceSize = sourceSize,
+        .lineCount = lineCount,
+        .checkpointCount = static_cast<uint32_t>(checkpoints.size()),
+    };
+    return file.write(&header, sizeof(header)) == sizeof(header) && file.write(checkpoints) == checkpoints.size() * sizeof(uint32_t);
+}
+
+uint32_t UFZ::LineIndex::seek(const File& file, const uint32_t line) const noexcept
+{
+    const size_t checkpoint = line / interval;
+    if (checkpoint >= checkpoints.size() || !file.seek(checkpoints[checkpoint], true))
+        return UINT32_MAX;
+    return static_cast<uint32_t>(checkpoint * interval);
+}
+
+uint32_t UFZ::LineIndex::lineAt(const uint64_t offset) const noexcept
+{
+    // Checkpoints are sorted, find the last one not past offset
+    size_t low = 0;
+    size_t high = checkpoints.size();
+    while (high - low > 1)
+    {
+        const size_t middle = (low + high) / 2;
+        if (checkpoints[middle] <= offset)
+            low = middle;
+        else
+            high = middle;
+    }
+    return static_cast<uint32_t>(low * interval);
+}
+
+uint32_t UFZ::LineIndex::getLineCount() const noexcept
+{
+    return lineCount;
+}
+
+uint64_t UFZ::LineIndex::getSourceSize() const noexcept
+{
+    return sourceSize;
+}
+
+void UFZ::LineIndex::clear() noexcept
+{
+    checkpoints.clear();
+    checkpoints.shrink_to_fit();
+    sourceSize = 0;
+    sourceTimestamp = 0;
+    lineCount = 0;
+}
+
+// =====================================================================================================================
+// ================================================== Filesystem batch =================================================
+// =====================================================================================================================
+
+void UFZ::FilesystemBatch::reserve(const size_t operations, const size_t pathBytes) noexcept
+{
+    this->operations.reserve(operations);
+    results.reserve(operations);
+    paths.reserve(pathBytes);
+}
+
+void UFZ::FilesystemBatch::remove(const char* path) noexcept
+{
+    add(Type::Remove, addPath(path), 0);
+}
+
+void UFZ::FilesystemBatch::rename(const char* oldPath, const char* newPath) noexcept
+{
+    const uint32_t oldOffset = addPath(oldPath);
+    add(Type::Rename, oldOffset, addPath(newPath));
+}
+
+void UFZ::FilesystemBatch::stat(const char* path) noexcept
+{
+    add(Type::Stat, addPath(path), 0);
+}
+
+void UFZ::FilesystemBatch::clear() noexcept
+{
+    operations.clear();
+    paths.clear();
+    results.clear();
+    infos.clear();
+    failures = 0;
+}
+
+bool UFZ::FilesystemBatch::runInBackground(Application& app, const std::function<void()>& onDone, const uint32_t loadingScene, const uint32_t loadingDelay) noexcept
+{
+    const Filesystem* filesystem = &app.getFilesystem();
+    return app.runInBackground([this, filesystem]() -> void
+    {
+        filesystem->run(*this);
+    }, onDone, loadingScene, loadingDelay);
+}
+
+size_t UFZ::FilesystemBatch::size() const noexcept
+{
+    return operations.size();
+}
+
+UFZ::FilesystemBatch::Type UFZ::FilesystemBatch::getType(const size_t i) const noexcept
+{
+    return operations[i].type;
+}
+
+const char* UFZ::FilesystemBatch::getPath(const size_t i) const noexcept
+{
+    return &paths[operations[i].path];
+}
+
+FS_Error UFZ::FilesystemBatch::getError(const size_t i) const noexcept
+{
+    return results[i];
+}
+
+const char* UFZ::FilesystemBatch::getErrorDescription(const size_t i) const noexcept
+{
+    return Filesystem::getErrorDescription(results[i]);
+}
+
+const FileInfo& UFZ::FilesystemBatch::getInfo(const size_t i) const noexcept
+{
+    // Other operations have no info slot, their index would point at another stat's result
+    furi_check(operations[i].type == Type::Stat);
+    return infos[operations[i].info];
+}
+
+size_t UFZ::FilesystemBatch::getFailures() const noexcept
+{
+    return failures;
+}
+
+void UFZ::FilesystemBatch::describeFailures(FuriString* out) const noexcept
+{
+    for (size_t i = 0; i < operations.size(); i++)
+        if (results[i] != FSE_OK)
+            furi_string_cat_printf(out, "%s: %s\n", getPath(i), getErrorDescription(i));
+}
+
+uint32_t UFZ::FilesystemBatch::addPath(const char* path) noexcept
+{
+    const auto offset = static_cast<uint32_t>(paths.size());
+    paths.insert(paths.end(), path, path + strlen(path) + 1);
+    return offset;
+}
+
+void UFZ::FilesystemBatch::add(const Type type, const uint32_t path, const uint32_t newPath) noexcept
+{
+    uint32_t info = 0;
+    if (type == Type::Stat)
+    {
+        info = static_cast<uint32_t>(infos.size());
+        infos.emplace_back();
+    }
+    operations.push_back({ type, path, newPath, info });
+    results.push_back(FSE_NOT_READY);
+}
+
+// =====================================================================================================================
+// =================================================== Filename index ==================================================
+// =====================================================================================================================
+
+void UFZ::FilenameIndex::init(const Filesystem& filesystem, const char* dirname) noexcept
+{
+    free();
+    storage = const_cast<Filesystem*>(&filesystem);
+    directory = furi_string_alloc_set_str(dirname);
+    const size_t length = strlen(dirname);
+    if (length > 1 && dirname[length - 1] == '/')
+        furi_string_left(directory, length - 1);
+    mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+
+    // Worker threads walk the list when they create or remove files
+    furi_mutex_acquire(storage->indicesMutex, FuriWaitForever);
+    nextIndex = storage->filenameIndices;
+    storage->filenameIndices = this;
+    furi_mutex_release(storage->indicesMutex);
+}
+
+void UFZ::FilenameIndex::free() noexcept
+{
+    if (storage != nullptr)
+    {
+        furi_mutex_acquire(storage->indicesMutex, FuriWaitForever);
+        FilenameIndex** link = &storage->filenameIndices;
+        while (*link != nullptr && *link != this)
+            link = &(*link)->nextIndex;
+        if (*link != nullptr)
+            *link = nextIndex;
+        furi_mutex_release(storage->indicesMutex);
+
+        storage = nullptr;
+        nextIndex = nullptr;
+    }
+    FREE_GUARD(furi_string_free, directory);
+    FREE_GUARD(furi_mutex_free, mutex);
+    for (auto& a : entries)
+        a.bValid = false;
+}
+
+bool UFZ::FilenameIndex::next(const char* prefix, const char* extension, FuriString* nextFilename) noexcept
+{
+    if (storage == nullptr || strlen(prefix) >= maxPrefixLength || strlen(extension) >= maxExtensionLength)
+        return false;
+
+    furi_mutex_acquire(mutex, FuriWaitForever);
+    Entry* entry = find(prefix, extension);
+    if (entry == nullptr)
+    {
+        // Reuse an empty entry or the least recently used one
+        entry = &entries[0];
+        for (auto& a : entries)
+        {
+            if (!a.bValid)
+            {
+                entry = &a;
+                break;
+            }
+            if (a.lastUse < entry->lastUse)
+                entry = &a;
+        }
+        entry->bValid = false;
+        entry->bStale = true;
+        entry->highest = -1;
+        strcpy(entry->prefix, prefix);
+        strcpy(entry->extension, extension);
+    }
+    if (entry->bStale)
+    {
+        if (!scan(*entry))
+        {
+            furi_mutex_release(mutex);
+            return false;
+        }
+        entry->bValid = true;
+        entry->bStale = false;
+    }
+    entry->lastUse = ++uses;
+
+    // The name is taken as soon as it is handed out, so a second call before the file exists gives a different one
+    entry->highest++;
+    if (entry->highest == 0)
+        furi_string_set_str(nextFilename, prefix);
+    else
+        furi_string_printf(nextFilename, "%s%ld", prefix, static_cast<long>(entry->highest));
+    furi_mutex_release(mutex);
+    return true;
+}
+
+void UFZ::FilenameIndex::invalidate() noexcept
+{
+    if (mutex != nullptr)
+        furi_mutex_acquire(mutex, FuriWaitForever);
+    for (auto& a : entries)
+        a.bStale = true;
+    if (mutex != nullptr)
+        furi_mutex_release(mutex);
+}
+
+UFZ::FilenameIndex::~FilenameIndex() noexcept
+{
+    free();
+}
+
+UFZ::FilenameIndex::Entry* UFZ::FilenameIndex::find(const char* prefix, const char* extension) noexcept
+{
+    for (auto& a : entries)
+        if (a.bValid && strcmp(a.prefix, prefix) == 0 && strcmp(a.extension, extension) == 0)
+            return &a;
+    return nullptr;
+}
+
+bool UFZ::FilenameIndex::scan(Entry& entry) const noexcept
+{
+    File file(*storage);
+    Directory dir;
+    if (!dir.open(file, furi_string_get_cstr(directory)))
+    {
+        // A directory that does not exist yet has no names in use
+        UNUSED(dir.close());
+        return !storage->exists(furi_string_get_cstr(directory));
+    }
+
+    // Names handed out before a rescan stay used even if their files were never created
+    FileInfo info;
+    char name[maxNameLength];
+    while (dir.read(&info, name, sizeof(name)))
+    {
+        const int32_t number = match(entry, name);
+        if (number > entry.highest)
+            entry.highest = number;
+    }
+    UNUSED(dir.close());
+    return true;
+}
+
+// Returns the numeric suffix of prefix<number>extension, 0 for prefix<extension> and -1 for names that do not match
+int32_t UFZ::FilenameIndex::match(const Entry& entry, const char* name) noexcept
+{
+    const size_t prefixLength = strlen(entry.prefix);
+    const size_t extensionLength = strlen(entry.extension);
+    const size_t length = strlen(name);
+    if (length < prefixLength + extensionLength || strncmp(name, entry.prefix, prefixLength) != 0 ||
+        strcmp(name + length - extensionLength, entry.extension) != 0)
+        return -1;
+
+    int32_t number = 0;
+    for (const char* c = name + prefixLength; c != name + length - extensionLength; c++)
+    {
+        if (*c < '0' || *c > '9' || number > (INT32_MAX - 9) / 10)
+            return -1;
+        number = number * 10 + (*c - '0');
+    }
+    return number;
+}
+
+// Returns the part of path after the indexed directory, or nullptr if path is not directly inside it
+const char* UFZ::FilenameIndex::nameIn(const char* path) const noexcept
+{
+    const size_t length = furi_string_size(directory);
+    if (strncmp(path, furi_string_get_cstr(directory), length) != 0 || path[length] != '/' || strchr(path + length + 1, '/') != nullptr)
+        return nullptr;
+    return path + length + 1;
+}
+
+void UFZ::FilenameIndex::created(const char* path) noexcept
+{
+    const char* name = nameIn(path);
+    if (name == nullptr)
+        return;
+
+    furi_mutex_acquire(mutex, FuriWaitForever);
+    for (auto& a : entries)
+    {
+        const int32_t number = a.bValid ? match(a, name) : -1;
+        if (number > a.highest)
+            a.highest = number;
+    }
+    furi_mutex_release(mutex);
+}
+
+// Removing a file leaves the highest number as is, gaps are not filled. Removing the directory itself or one of its
+// parents rescans on the next request.
+void UFZ::FilenameIndex::removed(const char* path) noexcept
+{
+    const size_t length = strlen(path);
+    if (strncmp(furi_string_get_cstr(directory), path, length) == 0 &&
+        (furi_string_size(directory) == length || furi_string_get_cstr(directory)[length] == '/'))
+        invalidate();
+}
@@ -1,11 +1,68 @@
 #pragma once
 #include "Common.hpp"
+#include <bit>
+#include <cstddef>
 #include <vector>
 
+// Describes a field of a serializable struct, see UFZ::Layout
+#define UFZ_FIELD(type, member) UFZ::Field<decltype(type::member), offsetof(type, member)>
+
+// Makes type readable and writable as a record, for example:
+// UFZ_SERIALIZABLE(Sample, 1, UFZ_FIELD(Sample, tick), UFZ_FIELD(Sample, value), UFZ_FIELD(Sample, flags));
+#define UFZ_SERIALIZABLE(type, version, ...) template<> struct UFZ::Serializer<type> : UFZ::Layout<type, version, __VA_ARGS__> {}
+
 namespace UFZ
 {
     class Filesystem;
 
+    template<typename T, size_t fieldOffset>
+    struct Field
+    {
+        static_assert(std::is_arithmetic_v<std::remove_all_extents_t<T>> || std::is_enum_v<std::remove_all_extents_t<T>>,
+                      "Fields must be numbers, enums or arrays of them");
+
+        static constexpr size_t offset = fieldOffset;
+        static constexpr size_t size = sizeof(T);
+    };
+
+    // Compile-time description of how a struct is stored: its fields in order, little endian and without padding,
+    // plus a version that File::readHeader checks. When the struct's own layout already matches (no padding and fields
+    // declared in order) records are read and written in place with a single call, otherwise field by field through a
+    // small stack buffer.
+    template<typename T, uint16_t layoutVersion, typename... Fields>
+    struct Layout
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Records are copied bytewise");
+        static_assert(std::endian::native == std::endian::little, "Records are stored little endian");
+
+        static constexpr uint16_t version = layoutVersion;
+        static constexpr size_t size = (Fields::size + ... + 0);
+
+        static constexpr bool bInPlace = []() -> bool
+        {
+            size_t offset = 0;
+            bool bResult = true;
+            ((bResult = bResult && Fields::offset == offset, offset += Fields::size), ...);
+            return bResult && offset == sizeof(T);
+        }();
+
+        static void pack(const T& record, uint8_t* out) noexcept
+        {
+            const auto* base = reinterpret_cast<const uint8_t*>(&record);
+            ((memcpy(out, base + Fields::offset, Fields::size), out += Fields::size), ...);
+        }
+
+        static void unpack(const uint8_t* in, T& record) noexcept
+        {
+            auto* base = reinterpret_cast<uint8_t*>(&record);
+            ((memcpy(base + Fields::offset, in, Fields::size), in += Fields::size), ...);
+        }
+    };
+
+    // Specialised through UFZ_SERIALIZABLE
+    template<typename T>
+    struct Serializer;
+
     class File
     {
     public:
@@ -65,6 +122,88 @@ namespace UFZ
             return write(buffer.data(), buffer.size() * sizeof(T));
         }
 
+        // Records of types declared with UFZ_SERIALIZABLE. A file of records usually starts with a header holding the
+        // layout's version and record size, readHeader returns false if they do not match the current ones.
+        template<typename T>
+        bool writeHeader() const noexcept
+        {
+            const RecordHeader header{ recordMagic, Serializer<T>::version, static_cast<uint16_t>(Serializer<T>::size) };
+            return write(&header, sizeof(header)) == sizeof(header);
+        }
+
+        template<typename T>
+        bool readHeader() const noexcept
+        {
+            RecordHeader header{};
+            return read(&header, sizeof(header)) == sizeof(header) && header.magic == recordMagic &&
+                   header.version == Serializer<T>::version && header.size == Serializer<T>::size;
+        }
+
+        template<typename T>
+        bool writeRecord(const T& record) const noexcept
+        {
+            return writeRecords(std::span<const T>(&record, 1)) == 1;
+        }
+
+        template<typename T>
+        bool readRecord(T& record) const noexcept
+        {
+            return readRecords(std::span<T>(&record, 1)) == 1;
+        }
+
+        // Return the number of whole records written or read
+        template<typename T>
+        size_t writeRecords(const std::span<const T> records) const noexcept
+        {
+            using L = Serializer<T>;
+            if constexpr (L::bInPlace)
+                return write(records.data(), records.size_bytes()) / L::size;
+            else
+            {
+                uint8_t buffer[recordBufferSize < L::size ? L::size : recordBufferSize];
+                const size_t perChunk = sizeof(buffer) / L::size;
+                size_t done = 0;
+                while (done < records.size())
+                {
+                    const size_t n = records.size() - done < perChunk ? records.size() - done : perChunk;
+                    for (size_t i = 0; i < n; i++)
+                        L::pack(records[done + i], buffer + i * L::size);
+
+                    const size_t written = write(buffer, n * L::size) / L::size;
+                    done += written;
+                    if (written != n)
+                        break;
+                }
+                return done;
+            }
+        }
+
+        template<typename T>
+        size_t readRecords(const std::span<T> records) const noexcept
+        {
+            using L = Serializer<T>;
+            if constexpr (L::bInPlace)
+                return read(records.data(), records.size_bytes()) / L::size;
+            else
+            {
+                uint8_t buffer[recordBufferSize < L::size ? L::size : recordBufferSize];
+                const size_t perChunk = sizeof(buffer) / L::size;
+                size_t done = 0;
+                while (done < records.size())
+                {
+                    const size_t n = records.size() - done < perChunk ? records.size() - done : perChunk;
+                    const size_t read = this->read(buffer, n * L::size) / L::size;
+                    for (size_t i = 0; i < read; i++)
+                        L::unpack(buffer + i * L::size, records[done + i]);
+
+                    done += read;
+                    if (read != n)
+                        break;
+                }
+                return done;
+            }
+        }
+
         [[nodiscard]] bool seek(uint32_t offset, bool bFromStart) const noexcept;
         [[nodiscard]] uint64_t tell() const noexcept;
         [[nodiscard]] bool truncate() const noexcept;
@@ -73,8 +212,23 @@ namespace UFZ
         [[nodiscard]] bool sync() const noexcept;
         [[nodiscard]] bool eof() const noexcept;
 
+        // Reserves bytes for the file up front in one contiguous run of clusters, so a long recording neither
+        // fragments the card nor pays for cluster allocation while writing. Only works on an empty file opened for
+        // writing. The file then reports the reserved size; on close it is cut back to the end of what was written.
+        bool preallocate(uint64_t bytes) noexcept;
+
         static bool copyToFile(const File& source, const File& destination, size_t size) noexcept;
 
+        // Read-ahead for streaming a file front to back: a background thread keeps up to chunkCount chunks of
+        // chunkSize bytes past the read position loaded, so read() only waits on storage when the consumer outruns the
+        // card. A seek() anywhere but the current position switches it off and continues without it. While it is on,
+        // only read(), seek(), tell() and eof() may be used.
+        bool enableReadAhead(size_t chunkSize = 4096, size_t chunkCount = 3, uint32_t stackSize = 2048) noexcept;
+        void disableReadAhead() noexcept;
+        [[nodiscard]] bool isReadAheadEnabled() const noexcept;
+
+        static constexpr size_t maxReadAheadChunks = 8;
+
         void close() noexcept;
 
         ~File() noexcept;
@@ -82,8 +236,30 @@ namespace UFZ
         friend class Filesystem;
         friend class Directory;
 
+        struct RecordHeader
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t size;
+        };
+
+        static constexpr uint32_t recordMagic = 0x525A4655; // "UFZR"
+
+        // Stack space used to convert records whose layout differs from their struct's
+        static constexpr size_t recordBufferSize = 128;
+
+        struct ReadAhead;
+
         ::File* file = nullptr;
         Filesystem* storage = nullptr;
+        // Mutable because a seek() away from the read position ends read-ahead, also on a const File
+        mutable ReadAhead* readAhead = nullptr;
+
+        // Set by preallocate(), dataEnd is the furthest any write reached and is where close() truncates. position is
+        // tracked from reads, writes and seeks so writes do not have to ask the storage service for it.
+        bool bPreallocated = false;
+        mutable uint64_t dataEnd = 0;
+        mutable uint64_t position = 0;
 
         // True while `file` is open as a directory (via Directory::open): selects
         // storage_dir_close over storage_file_close at teardown so the handle is not
@@ -92,6 +268,256 @@ namespace UFZ
 
         void init() noexcept;
         void free() noexcept;
+        void stopReadAhead() const noexcept;
+    };
+
+    // Remembers where every interval-th line of a text file starts, so any line can be reached with one seek and a
+    // short forward read. Lines end after a newline or once they reach maxLineLength bytes. The index can be saved to
+    // a sidecar file together with the source's size and timestamp and is reused from there while both still match,
+    // so a large asset only has to be scanned once.
+    class LineIndex
+    {
+    public:
+        static constexpr uint32_t interval = 32;
+        static constexpr uint32_t maxLineLength = 64;
+
+        // Splits a byte stream into lines by the rules above, anything reading lines after a seek must use it too
+        struct Splitter
+        {
+            size_t length = 0;
+
+            // Returns true if c ends the current line
+            bool feed(const char c) noexcept
+            {
+                length++;
+                if (c == '\n' || length == maxLineLength)
+                {
+                    length = 0;
+                    return true;
+                }
+                return false;
+            }
+        };
+
+        LineIndex() = default;
+
+        // Scans the whole file from the start
+        bool build(const File& file) noexcept;
+
+        // Loads the sidecar at indexPath if it was built with the same settings from a source of this size and
+        // timestamp, otherwise builds the index from source and writes the sidecar. sourcePath is only used for its
+        // timestamp.
+        bool open(const Filesystem& filesystem, const char* sourcePath, const File& source, const char* indexPath) noexcept;
+
+        bool load(const Filesystem& filesystem, const char* indexPath, uint64_t sourceSize, uint32_t sourceTimestamp) noexcept;
+        bool save(const Filesystem& filesystem, const char* indexPath) const noexcept;
+
+        // Seeks file to the closest indexed line at or before line and returns that line's number, or UINT32_MAX if
+        // the line is past the end of the index or the seek failed
+        [[nodiscard]] uint32_t seek(const File& file, uint32_t line) const noexcept;
+
+        // Number of the last indexed line at or before byte offset
+        [[nodiscard]] uint32_t lineAt(uint64_t offset) const noexcept;
+        [[nodiscard]] uint32_t getLineCount() const noexcept;
+        [[nodiscard]] uint64_t getSourceSize() const noexcept;
+
+        void clear() noexcept;
+    private:
+        struct Header
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t interval;
+            uint32_t maxLineLength;
+            uint32_t sourceTimestamp;
+            uint64_t sourceSize;
+            uint32_t lineCount;
+            uint32_t checkpointCount;
+        };
+        static_assert(sizeof(Header) == 32, "The sidecar header layout is part of the file format");
+
+        static constexpr uint32_t magic = 0x49445A55; // "UZDI"
+        static constexpr uint16_t version = 1;
+
+        std::vector<uint32_t> checkpoints{};
+        uint64_t sourceSize = 0;
+        uint32_t sourceTimestamp = 0;
+        uint32_t lineCount = 0;
+    };
+
+    // Write-behind sink for continuous recording. The producer copies into one of bufferCount buffers while a writer
+    // thread flushes the ones already filled, so a slow FAT cluster allocation stalls the writer instead of the
+    // producer. If every other buffer is still waiting to be written the data is dropped and counted as an overrun.
+    // The file is synced every syncInterval milliseconds while data keeps coming. write() and flush() must be called
+    // from a single producer, which may be an interrupt. Buffers are allocated in open(), nothing after that.
+    class CaptureSink
+    {
+    public:
+        static constexpr size_t maxBuffers = 4;
+
+        struct Stats
+        {
+            uint32_t bytesWritten;
+            uint32_t droppedBytes;
+            uint32_t overruns;
+
+            // Over the time since open(), and over the time spent inside File::write only
+            uint32_t averageRate;
+            uint32_t storageRate;
+
+            // Longest single buffer write in milliseconds, the stall the buffers have to cover
+            uint32_t longestWrite;
+            uint32_t syncs;
+            bool bError;
+        };
+
+        CaptureSink() = default;
+
+        // Owns the buffers and a thread that points back at this object
+        CaptureSink(const CaptureSink&) = delete;
+        CaptureSink& operator=(const CaptureSink&) = delete;
+
+        bool open(const Filesystem& filesystem, const char* path, size_t bufferSize = 4096, size_t bufferCount = 2, uint32_t syncInterval = 1000, uint32_t stackSize = 2048) noexcept;
+
+        // Flushes what is buffered, waits for the writer and closes the file
+        void close() noexcept;
+
+        // Returns how many bytes were accepted, the rest was dropped
+        size_t write(const void* data, size_t size) noexcept;
+
+        // Hands the partly filled buffer to the writer, e.g. before a pause in the stream
+        void flush() noexcept;
+
+        [[nodiscard]] Stats getStats() const noexcept;
+        [[nodiscard]] bool isOpen() const noexcept;
+
+        ~CaptureSink() noexcept;
+    private:
+        static constexpr uint32_t readyFlag = 1 << 0;
+        static constexpr uint32_t exitFlag = 1 << 1;
+
+        File file{};
+        FuriThread* thread = nullptr;
+
+        uint8_t* memory = nullptr;
+        size_t bufferSize = 0;
+        size_t bufferCount = 0;
+        uint32_t syncTicks = 0;
+
+        // A buffer belongs to the producer while it is not ready and to the writer while it is
+        std::atomic<bool> bReady[maxBuffers]{};
+        size_t lengths[maxBuffers]{};
+
+        // Producer side
+        size_t filling = 0;
+        size_t fill = 0;
+
+        // Written by the writer, read by getStats()
+        std::atomic<uint32_t> bytesWritten = 0;
+        std::atomic<uint32_t> droppedBytes = 0;
+        std::atomic<uint32_t> overruns = 0;
+        std::atomic<uint32_t> writeTicks = 0;
+        std::atomic<uint32_t> longestWrite = 0;
+        std::atomic<uint32_t> syncs = 0;
+        std::atomic<bool> bError = false;
+        uint32_t openTick = 0;
+
+        void submit() noexcept;
+        void drain(size_t& next) noexcept;
+    };
+
+    // Read-only archive of many small files, opened once instead of once per file. Built on the host with
+    // Tools/ufzpack.py. Layout, little endian:
+    //   Header            { uint32 magic "UFZP", uint16 version, uint16 alignment, uint32 entryCount, uint32 namesSize }
+    //   Record[entryCount] { uint32 hash, uint32 nameOffset, uint32 offset, uint32 size }, sorted by hash then name
+    //   Names             namesSize bytes of NUL terminated names, nameOffset is relative to their start
+    //   Blobs             at their absolute offset, each aligned to alignment bytes
+    // The hash is 32 bit FNV-1a of the name. Only the index is kept in RAM; entries are read straight from the
+    // archive through its single handle.
+    class PackReader
+    {
+    public:
+        // A read-only view of one entry. Reading moves the archive's handle, so entries of one pack must not be read
+        // from different threads at the same time. Valid until the pack is closed.
+        class Entry
+        {
+        public:
+            Entry() = default;
+
+            size_t read(void* buffer, size_t bytesToRead) noexcept;
+
+            // Reads the whole entry, appending it to buffer
+            size_t read(std::vector<uint8_t>& buffer) noexcept;
+
+            [[nodiscard]] bool seek(uint32_t offset, bool bFromStart) noexcept;
+            [[nodiscard]] uint64_t tell() const noexcept;
+            [[nodiscard]] uint64_t size() const noexcept;
+            [[nodiscard]] bool eof() const noexcept;
+            [[nodiscard]] bool isValid() const noexcept;
+        private:
+            friend class PackReader;
+
+            PackReader* pack = nullptr;
+            uint32_t offset = 0;
+            uint32_t length = 0;
+            uint32_t position = 0;
+        };
+
+        PackReader() = default;
+
+        // Entries point back at the reader
+        PackReader(const PackReader&) = delete;
+        PackReader& operator=(const PackReader&) = delete;
+
+        bool open(const Filesystem& filesystem, const char* path) noexcept;
+        void close() noexcept;
+
+        // Returns an invalid entry if there is no entry called name
+        [[nodiscard]] Entry find(const char* name) noexcept;
+
+        [[nodiscard]] size_t size() const noexcept;
+        [[nodiscard]] const char* getName(size_t i) const noexcept;
+
+        [[nodiscard]] static constexpr uint32_t hash(const char* name) noexcept
+        {
+            uint32_t result = 2166136261u;
+            for (; *name != '\0'; name++)
+            {
+                result ^= static_cast<uint8_t>(*name);
+                result *= 16777619u;
+            }
+            return result;
+        }
+    private:
+        struct Header
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t alignment;
+            uint32_t entryCount;
+            uint32_t namesSize;
+        };
+
+        struct Record
+        {
+            uint32_t hash;
+            uint32_t nameOffset;
+            uint32_t offset;
+            uint32_t size;
+        };
+        static_assert(sizeof(Header) == 16 && sizeof(Record) == 16, "The pack layout is part of the file format");
+
+        static constexpr uint32_t magic = 0x505A4655; // "UFZP"
+        static constexpr uint16_t version = 1;
+
+        File file{};
+        std::vector<Record> records{};
+        std::vector<char> names{};
+
+        // Where the handle is, so sequential reads of an entry do not seek
+        uint64_t filePosition = 0;
+
+        size_t readAt(uint32_t offset, void* buffer, size_t bytes) noexcept;
     };
 
     class Directory
@@ -110,4 +536,141 @@ namespace UFZ
 
         File* file{};
     };
+
+    // A list of remove, rename and stat operations run back to back, either directly with Filesystem::run or on the
+    // application's worker thread so deleting a folder's worth of files does not block the GUI. Paths are copied into
+    // one buffer when added. Every operation runs even if earlier ones fail and gets its own FS_Error.
+    class FilesystemBatch
+    {
+    public:
+        enum class Type : uint8_t
+        {
+            Remove,
+            Rename,
+            Stat
+        };
+
+        FilesystemBatch() = default;
+
+        void reserve(size_t operations, size_t pathBytes) noexcept;
+
+        void remove(const char* path) noexcept;
+        void rename(const char* oldPath, const char* newPath) noexcept;
+        void stat(const char* path) noexcept;
+
+        // Drops the operations and their results
+        void clear() noexcept;
+
+        // Runs the batch on app's BackgroundWorker, see Application::runInBackground. The batch must stay alive and
+        // unchanged until onDone is called. Returns false if the worker is busy.
+        bool runInBackground(Application& app, const std::function<void()>& onDone, uint32_t loadingScene, uint32_t loadingDelay = 250) noexcept;
+
+        [[nodiscard]] size_t size() const noexcept;
+        [[nodiscard]] Type getType(size_t i) const noexcept;
+        [[nodiscard]] const char* getPath(size_t i) const noexcept;
+
+        // Results are FSE_NOT_READY until the batch has run
+        [[nodiscard]] FS_Error getError(size_t i) const noexcept;
+        [[nodiscard]] const char* getErrorDescription(size_t i) const noexcept;
+
+        // Only valid for stat operations that succeeded, crashes for any other type
+        [[nodiscard]] const FileInfo& getInfo(size_t i) const noexcept;
+
+        [[nodiscard]] size_t getFailures() const noexcept;
+
+        // Appends a "path: error" line to out for every failed operation
+        void describeFailures(FuriString* out) const noexcept;
+    private:
+        friend class Filesystem;
+
+        struct Operation
+        {
+            Type type;
+
+            // Offsets into paths, newPath is only used by renames and info only by stats
+            uint32_t path;
+            uint32_t newPath;
+            uint32_t info;
+        };
+
+        std::vector<Operation> operations{};
+        std::vector<char> paths{};
+        std::vector<FS_Error> results{};
+        std::vector<FileInfo> infos{};
+        size_t failures = 0;
+
+        uint32_t addPath(const char* path) noexcept;
+        void add(Type type, uint32_t path, uint32_t newPath) noexcept;
+    };
+
+    // Hands out the names Filesystem::getNextFilename picks, prefix, prefix1, prefix2..., without probing the storage
+    // once per candidate. The directory is read once per prefix and extension, after that the highest number in use
+    // is kept in a small cache and every name costs O(1). Files created or renamed through the Filesystem the index was
+    // initialised with keep the cache up to date; call invalidate() if something else changes the directory.
+    //
+    // Unlike getNextFilename the next number is always above the highest one in use or handed out, gaps left by removed
+    // files are not filled.
+    class FilenameIndex
+    {
+    public:
+        // Prefix and extension pairs cached at once, the least recently used one is dropped first
+        static constexpr size_t maxEntries = 4;
+        static constexpr size_t maxPrefixLength = 32;
+        static constexpr size_t maxExtensionLength = 8;
+
+        // Longer names in the directory are ignored
+        static constexpr size_t maxNameLength = 64;
+
+        FilenameIndex() = default;
+
+        // Registered with the filesystem by address
+        FilenameIndex(const FilenameIndex&) = delete;
+        FilenameIndex& operator=(const FilenameIndex&) = delete;
+
+        void init(const Filesystem& filesystem, const char* dirname) noexcept;
+        void free() noexcept;
+
+        // Sets nextFilename to the name without directory or extension, like getNextFilename. The name counts as used
+        // from here on, a second call returns the one after it. Returns false if the directory could not be read.
+        bool next(const char* prefix, const char* extension, FuriString* nextFilename) noexcept;
+
+        // Rescans the directory on the next request, numbers already handed out are not given out again
+        void invalidate() noexcept;
+
+        ~FilenameIndex() noexcept;
+    private:
+        friend class Filesystem;
+
+        struct Entry
+        {
+            char prefix[maxPrefixLength];
+            char extension[maxExtensionLength];
+
+            // -1 if no name is in use, 0 if only the bare prefix is
+            int32_t highest;
+            uint32_t lastUse;
+            bool bValid;
+
+            // Needs a rescan, whose result is merged with highest
+            bool bStale;
+        };
+
+        Filesystem* storage = nullptr;
+        FilenameIndex* nextIndex = nullptr;
+        FuriString* directory = nullptr;
+
+        // Filesystem calls made from worker threads update the cache too
+        FuriMutex* mutex = nullptr;
+
+        Entry entries[maxEntries]{};
+        uint32_t uses = 0;
+
+        [[nodiscard]] Entry* find(const char* prefix, const char* extension) noexcept;
+        bool scan(Entry& entry) const noexcept;
+        [[nodiscard]] static int32_t match(const Entry& entry, const char* name) noexcept;
+        [[nodiscard]] const char* nameIn(const char* path) const noexcept;
+
+        void created(const char* path) noexcept;
+        void removed(const char* path) noexcept;
+    };
 }
\ No newline at end of file
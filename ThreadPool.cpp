@@ -0,0 +1,210 @@
+#include "ThreadPool.hpp"
+
+// =====================================================================================================================
+// ======================================================= Queue =======================================================
+// =====================================================================================================================
+
+size_t UFZ::ThreadPool::Queue::free() const noexcept
+{
+    return queueCapacity - (tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire));
+}
+
+void UFZ::ThreadPool::Queue::push(const Task task, void* context, const uint32_t begin, const uint32_t end, const uint8_t group) noexcept
+{
+    const uint32_t t = tail.load(std::memory_order_relaxed);
+    Slot& slot = slots[t & (queueCapacity - 1)];
+    slot.task.store(task, std::memory_order_relaxed);
+    slot.context.store(context, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.group.store(group, std::memory_order_relaxed);
+
+    // Publishes the slot to the consumers
+    tail.store(t + 1, std::memory_order_release);
+}
+
+bool UFZ::ThreadPool::Queue::pop(Task& task, void*& context, uint32_t& begin, uint32_t& end, uint8_t& group) noexcept
+{
+    uint32_t h = head.load(std::memory_order_acquire);
+    while (h != tail.load(std::memory_order_acquire))
+    {
+        const Slot& slot = slots[h & (queueCapacity - 1)];
+        task = slot.task.load(std::memory_order_relaxed);
+        context = slot.context.load(std::memory_order_relaxed);
+        begin = slot.begin.load(std::memory_order_relaxed);
+        end = slot.end.load(std::memory_order_relaxed);
+        group = slot.group.load(std::memory_order_relaxed);
+
+        // The producer only reuses the slot once head has moved past it, so if this succeeds the copy is intact
+        if (head.compare_exchange_weak(h, h + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            return true;
+    }
+    return false;
+}
+
+// =====================================================================================================================
+// ==================================================== Thread pool ====================================================
+// =====================================================================================================================
+
+void UFZ::ThreadPool::start(const Application& app, const size_t threads, const uint32_t stackSize) noexcept
+{
+    stop();
+    application = &app;
+    threadCount = threads == 0 ? 1 : (threads > maxThreads ? maxThreads : threads);
+
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        workers[i] = { this, nullptr, i };
+        workers[i].thread = furi_thread_alloc_ex("UFZPool", stackSize, [](void* context) -> int32_t
+        {
+            const auto* worker = static_cast<Worker*>(context);
+            bool bExit = false;
+            while (true)
+            {
+                // The work and exit flags can arrive in the same wait, so the queues are drained once more after
+                // exit is seen. Nothing is submitted after stop(), every group still reaches zero.
+                while (worker->pool->runOne(worker->index))
+                    ;
+                if (bExit)
+                    return 0;
+
+                // Flags stay set until waited on, so work pushed after the queues were found empty still wakes us
+                const uint32_t flags = furi_thread_flags_wait(workFlag | exitFlag, FuriFlagWaitAny, FuriWaitForever);
+                bExit = (flags & FuriFlagError) == 0 && (flags & exitFlag) != 0;
+            }
+        }, &workers[i]);
+        furi_thread_start(workers[i].thread);
+    }
+}
+
+void UFZ::ThreadPool::stop() noexcept
+{
+    // Workers drain everything queued before they exit
+    for (size_t i = 0; i < threadCount; i++)
+        furi_thread_flags_set(furi_thread_get_id(workers[i].thread), exitFlag);
+
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        furi_thread_join(workers[i].thread);
+        furi_thread_free(workers[i].thread);
+        workers[i].thread = nullptr;
+    }
+    threadCount = 0;
+    nextWorker = 0;
+}
+
+bool UFZ::ThreadPool::submit(const Task task, void* context, const uint32_t doneEvent) noexcept
+{
+    return parallelFor(0, 1, 1, task, context, doneEvent);
+}
+
+bool UFZ::ThreadPool::parallelFor(const uint32_t begin, const uint32_t end, uint32_t grain, const Task task, void* context, const uint32_t doneEvent) noexcept
+{
+    const size_t room = freeSlots();
+    if (threadCount == 0 || end <= begin || room == 0)
+        return false;
+
+    const uint32_t size = end - begin;
+    if (grain == 0)
+        grain = (size + static_cast<uint32_t>(threadCount) * 4 - 1) / (static_cast<uint32_t>(threadCount) * 4);
+    if (grain == 0)
+        grain = 1;
+
+    uint32_t chunks = (size + grain - 1) / grain;
+    if (chunks > room)
+    {
+        chunks = static_cast<uint32_t>(room);
+        grain = (size + chunks - 1) / chunks;
+        chunks = (size + grain - 1) / grain;
+    }
+
+    const uint8_t group = acquireGroup(chunks, doneEvent);
+    if (group == UINT8_MAX)
+        return false;
+
+    // Consumers only ever make room, so the free slots counted above are still there
+    for (uint32_t first = begin; first != end;)
+    {
+        const uint32_t last = end - first > grain ? first + grain : end;
+        while (queues[nextWorker].free() == 0)
+            nextWorker = (nextWorker + 1) % threadCount;
+        queues[nextWorker].push(task, context, first, last, group);
+        nextWorker = (nextWorker + 1) % threadCount;
+        first = last;
+    }
+    wake();
+    return true;
+}
+
+bool UFZ::ThreadPool::isIdle() const noexcept
+{
+    for (const auto& a : groups)
+        if (a.remaining.load(std::memory_order_acquire) != 0)
+            return false;
+    return true;
+}
+
+size_t UFZ::ThreadPool::getThreadCount() const noexcept
+{
+    return threadCount;
+}
+
+UFZ::ThreadPool::~ThreadPool() noexcept
+{
+    stop();
+}
+
+size_t UFZ::ThreadPool::freeSlots() const noexcept
+{
+    size_t result = 0;
+    for (size_t i = 0; i < threadCount; i++)
+        result += queues[i].free();
+    return result;
+}
+
+uint8_t UFZ::ThreadPool::acquireGroup(const uint32_t chunks, const uint32_t event) noexcept
+{
+    for (size_t i = 0; i < maxGroups; i++)
+    {
+        // Only the submitting thread takes groups, workers only release them
+        if (groups[i].remaining.load(std::memory_order_acquire) == 0)
+        {
+            groups[i].event = event;
+            groups[i].remaining.store(chunks, std::memory_order_release);
+            return static_cast<uint8_t>(i);
+        }
+    }
+    return UINT8_MAX;
+}
+
+void UFZ::ThreadPool::wake() const noexcept
+{
+    for (size_t i = 0; i < threadCount; i++)
+        furi_thread_flags_set(furi_thread_get_id(workers[i].thread), workFlag);
+}
+
+// Runs the oldest chunk of the worker's own queue, or of the next ones. Returns false if every queue was empty.
+bool UFZ::ThreadPool::runOne(const size_t self) noexcept
+{
+    Task task;
+    void* context;
+    uint32_t begin;
+    uint32_t end;
+    uint8_t group;
+
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        if (!queues[(self + i) % threadCount].pop(task, context, begin, end, group))
+            continue;
+
+        task(context, begin, end);
+
+        // The event is read before the group is released, after that the submitting thread may reuse it
+        Group& g = groups[group];
+        const uint32_t event = g.event;
+        if (g.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            application->getViewDispatcher().sendCustomEvent(event);
+        return true;
+    }
+    return false;
+}
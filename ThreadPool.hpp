@@ -0,0 +1,112 @@
+#pragma once
+#include "Common.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace UFZ
+{
+    // A few worker threads for splitting CPU heavy work, such as decoding, while the GUI keeps running. Each worker
+    // has a bounded lock-free FIFO queue filled round robin by the submitting thread; a worker drains its own queue
+    // first and then takes from the others, so uneven chunks still keep every thread busy. Every consumer, owner or
+    // not, takes chunks from the head in submission order. When everything submitted by one call has run, its event
+    // is sent to the GUI thread with ViewDispatcher::sendCustomEvent and reaches the current scene like any other
+    // custom event.
+    //
+    // Work is only submitted from one thread, normally the GUI thread. The pool only uses FuriThread and thread flags,
+    // Tools/Host provides those on top of std::thread and runs its tests on a host.
+    class ThreadPool
+    {
+    public:
+        static constexpr size_t maxThreads = 4;
+
+        // Per worker, must be a power of two
+        static constexpr size_t queueCapacity = 16;
+
+        // Calls submitted or split by parallelFor that can be in flight at once
+        static constexpr size_t maxGroups = 8;
+
+        static constexpr uint32_t defaultStackSize = 1024;
+
+        // Runs the elements [begin, end) of a range, submit() passes [0, 1)
+        using Task = void(*)(void* context, uint32_t begin, uint32_t end);
+
+        ThreadPool() = default;
+
+        // Owns threads that point back at this object
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Call stop() before the application is destroyed, completion events are sent through its view dispatcher
+        void start(const Application& app, size_t threads, uint32_t stackSize = defaultStackSize) noexcept;
+        void stop() noexcept;
+
+        // Returns false if the queues or the group table are full
+        bool submit(Task task, void* context, uint32_t doneEvent) noexcept;
+
+        // Splits [begin, end) into chunks of at least grain elements spread over the workers, grain 0 picks a size
+        // that gives every thread a few chunks to balance with. Fewer, larger chunks are used when the queues do not
+        // have room for all of them.
+        bool parallelFor(uint32_t begin, uint32_t end, uint32_t grain, Task task, void* context, uint32_t doneEvent) noexcept;
+
+        // True when nothing submitted is queued or running
+        [[nodiscard]] bool isIdle() const noexcept;
+        [[nodiscard]] size_t getThreadCount() const noexcept;
+
+        ~ThreadPool() noexcept;
+    private:
+        static constexpr uint32_t workFlag = 1 << 0;
+        static constexpr uint32_t exitFlag = 1 << 1;
+
+        // Fields are atomic so a consumer that loses the race for a slot reading it while it is refilled is not a
+        // data race, the copy is simply discarded
+        struct Slot
+        {
+            std::atomic<Task> task;
+            std::atomic<void*> context;
+            std::atomic<uint32_t> begin;
+            std::atomic<uint32_t> end;
+            std::atomic<uint8_t> group;
+        };
+
+        // Single producer, many consumers, first in first out. Only the submitting thread moves tail, the owner and
+        // the other workers alike claim the slot at head with a compare-exchange.
+        struct Queue
+        {
+            Slot slots[queueCapacity];
+            alignas(64) std::atomic<uint32_t> head;
+            alignas(64) std::atomic<uint32_t> tail;
+
+            [[nodiscard]] size_t free() const noexcept;
+            void push(Task task, void* context, uint32_t begin, uint32_t end, uint8_t group) noexcept;
+            bool pop(Task& task, void*& context, uint32_t& begin, uint32_t& end, uint8_t& group) noexcept;
+        };
+
+        struct Group
+        {
+            std::atomic<uint32_t> remaining;
+            uint32_t event;
+        };
+
+        struct Worker
+        {
+            ThreadPool* pool;
+            FuriThread* thread;
+            size_t index;
+        };
+
+        const Application* application = nullptr;
+
+        Queue queues[maxThreads]{};
+        Group groups[maxGroups]{};
+        Worker workers[maxThreads]{};
+        size_t threadCount = 0;
+        size_t nextWorker = 0;
+
+        [[nodiscard]] size_t freeSlots() const noexcept;
+        [[nodiscard]] uint8_t acquireGroup(uint32_t chunks, uint32_t event) noexcept;
+        void wake() const noexcept;
+
+        bool runOne(size_t self) noexcept;
+    };
+}
@@ -0,0 +1,302 @@
+// Threads, thread flags, mutexes, semaphores, the tick and FuriString on top of the C++ standard library, enough for
+// the wrapper's threading code to run unchanged on a host.
+#include <furi.h>
+
+#include <chrono>
+#include <cstdarg>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct FuriThread
+{
+    std::thread thread;
+    FuriThreadCallback callback;
+    void* context;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    uint32_t flags;
+};
+
+struct FuriMutex
+{
+    std::recursive_mutex mutex;
+};
+
+struct FuriString
+{
+    std::string string;
+};
+
+struct FuriSemaphore
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+    uint32_t count;
+    uint32_t max;
+};
+
+static thread_local FuriThread* currentThread = nullptr;
+
+static void catPrintf(FuriString* string, const char* format, va_list args)
+{
+    va_list copy;
+    va_copy(copy, args);
+    const int length = vsnprintf(nullptr, 0, format, copy);
+    va_end(copy);
+    if (length <= 0)
+        return;
+
+    const size_t offset = string->string.size();
+    string->string.resize(offset + length + 1);
+    vsnprintf(string->string.data() + offset, length + 1, format, args);
+    string->string.resize(offset + length);
+}
+
+extern "C"
+{
+    void __furi_crash(const char* message)
+    {
+        fprintf(stderr, "furi_crash: %s\n", message);
+        abort();
+    }
+
+    uint32_t furi_get_tick(void)
+    {
+        using namespace std::chrono;
+        return static_cast<uint32_t>(duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+    }
+
+    uint32_t furi_kernel_get_tick_frequency(void)
+    {
+        return 1000;
+    }
+
+    uint32_t furi_ms_to_ticks(const uint32_t ms)
+    {
+        return ms;
+    }
+
+    // The device's core clock
+    uint32_t furi_hal_cortex_instructions_per_microsecond(void)
+    {
+        return 64;
+    }
+
+    uint32_t host_cycle_counter(void)
+    {
+        using namespace std::chrono;
+        return static_cast<uint32_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() * 64 / 1000);
+    }
+
+    void furi_delay_ms(const uint32_t ms)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+
+    void furi_delay_tick(const uint32_t ticks)
+    {
+        furi_delay_ms(ticks);
+    }
+
+    FuriThread* furi_thread_alloc_ex(const char* name, const uint32_t stack_size, const FuriThreadCallback callback, void* context)
+    {
+        UNUSED(name);
+        UNUSED(stack_size);
+        return new FuriThread{ {}, callback, context, {}, {}, 0 };
+    }
+
+    void furi_thread_free(FuriThread* thread)
+    {
+        delete thread;
+    }
+
+    void furi_thread_start(FuriThread* thread)
+    {
+        thread->thread = std::thread([thread]() -> void
+        {
+            currentThread = thread;
+            UNUSED(thread->callback(thread->context));
+        });
+    }
+
+    bool furi_thread_join(FuriThread* thread)
+    {
+        if (thread->thread.joinable())
+            thread->thread.join();
+        return true;
+    }
+
+    FuriThreadId furi_thread_get_id(FuriThread* thread)
+    {
+        return thread;
+    }
+
+    FuriThreadId furi_thread_get_current_id(void)
+    {
+        return currentThread;
+    }
+
+    uint32_t furi_thread_flags_set(const FuriThreadId id, const uint32_t flags)
+    {
+        auto* thread = static_cast<FuriThread*>(id);
+        uint32_t result;
+        {
+            std::lock_guard lock(thread->mutex);
+            thread->flags |= flags;
+            result = thread->flags;
+        }
+        thread->condition.notify_all();
+        return result;
+    }
+
+    uint32_t furi_thread_flags_wait(const uint32_t flags, const uint32_t options, const uint32_t timeout)
+    {
+        FuriThread* thread = currentThread;
+        std::unique_lock lock(thread->mutex);
+        const auto ready = [&]() -> bool
+        {
+            return (options & FuriFlagWaitAll) ? (thread->flags & flags) == flags : (thread->flags & flags) != 0;
+        };
+
+        if (timeout == FuriWaitForever)
+            thread->condition.wait(lock, ready);
+        else if (!thread->condition.wait_for(lock, std::chrono::milliseconds(timeout), ready))
+            return FuriFlagErrorTimeout;
+
+        const uint32_t result = thread->flags & flags;
+        if ((options & FuriFlagNoClear) == 0)
+            thread->flags &= ~result;
+        return result;
+    }
+
+    FuriMutex* furi_mutex_alloc(const FuriMutexType type)
+    {
+        UNUSED(type);
+        return new FuriMutex;
+    }
+
+    void furi_mutex_free(FuriMutex* mutex)
+    {
+        delete mutex;
+    }
+
+    FuriStatus furi_mutex_acquire(FuriMutex* mutex, const uint32_t timeout)
+    {
+        UNUSED(timeout);
+        mutex->mutex.lock();
+        return FuriStatusOk;
+    }
+
+    FuriStatus furi_mutex_release(FuriMutex* mutex)
+    {
+        mutex->mutex.unlock();
+        return FuriStatusOk;
+    }
+
+    FuriSemaphore* furi_semaphore_alloc(const uint32_t max, const uint32_t initial)
+    {
+        return new FuriSemaphore{ {}, {}, initial, max };
+    }
+
+    void furi_semaphore_free(FuriSemaphore* semaphore)
+    {
+        delete semaphore;
+    }
+
+    FuriStatus furi_semaphore_acquire(FuriSemaphore* semaphore, const uint32_t timeout)
+    {
+        std::unique_lock lock(semaphore->mutex);
+        const auto ready = [&]() -> bool { return semaphore->count > 0; };
+        if (timeout == FuriWaitForever)
+            semaphore->condition.wait(lock, ready);
+        else if (!semaphore->condition.wait_for(lock, std::chrono::milliseconds(timeout), ready))
+            return FuriStatusErrorTimeout;
+        semaphore->count--;
+        return FuriStatusOk;
+    }
+
+    FuriStatus furi_semaphore_release(FuriSemaphore* semaphore)
+    {
+        {
+            std::lock_guard lock(semaphore->mutex);
+            if (semaphore->count >= semaphore->max)
+                return FuriStatusError;
+            semaphore->count++;
+        }
+        semaphore->condition.notify_one();
+        return FuriStatusOk;
+    }
+
+    FuriString* furi_string_alloc(void)
+    {
+        return new FuriString;
+    }
+
+    FuriString* furi_string_alloc_set_str(const char* string)
+    {
+        return new FuriString{ string };
+    }
+
+    void furi_string_free(FuriString* string)
+    {
+        delete string;
+    }
+
+    const char* furi_string_get_cstr(const FuriString* string)
+    {
+        return string->string.c_str();
+    }
+
+    void furi_string_set_str(FuriString* string, const char* value)
+    {
+        string->string = value;
+    }
+
+    void furi_string_cat_str(FuriString* string, const char* value)
+    {
+        string->string += value;
+    }
+
+    void furi_string_cat_printf(FuriString* string, const char* format, ...)
+    {
+        va_list args;
+        va_start(args, format);
+        catPrintf(string, format, args);
+        va_end(args);
+    }
+
+    void furi_string_printf(FuriString* string, const char* format, ...)
+    {
+        string->string.clear();
+        va_list args;
+        va_start(args, format);
+        catPrintf(string, format, args);
+        va_end(args);
+    }
+
+    void furi_string_reset(FuriString* string)
+    {
+        string->string.clear();
+    }
+
+    void furi_string_left(FuriString* string, const size_t index)
+    {
+        if (index < string->string.size())
+            string->string.resize(index);
+    }
+
+    size_t furi_string_size(const FuriString* string)
+    {
+        return string->string.size();
+    }
+
+    void furi_string_reserve(FuriString* string, const size_t size)
+    {
+        string->string.reserve(size);
+    }
+}
@@ -0,0 +1,513 @@
+// The storage service on top of the host's filesystem. /ext and /any map to the directory in UFZ_HOST_EXT, or ./ext
+// when it is not set, and /data maps to a host application's folder inside it. Any other path is rejected, like the
+// real service does with relative ones.
+#include <furi.h>
+#include <storage/storage.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <filesystem>
+#include <string>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+struct Storage
+{
+    int unused;
+};
+
+struct File
+{
+    FILE* file;
+    DIR* dir;
+    FS_Error error;
+};
+
+static Storage storage{};
+
+static std::string root() noexcept
+{
+    const char* ext = getenv("UFZ_HOST_EXT");
+    return ext != nullptr ? ext : "ext";
+}
+
+static bool startsWith(const std::string& path, const char* prefix) noexcept
+{
+    const size_t length = strlen(prefix);
+    return path.compare(0, length, prefix) == 0 && (path.size() == length || path[length] == '/');
+}
+
+// Returns an empty string for paths the service would reject
+static std::string hostPath(const char* path) noexcept
+{
+    const std::string p = path != nullptr ? path : "";
+    if (startsWith(p, STORAGE_EXT_PATH_PREFIX) || startsWith(p, STORAGE_ANY_PATH_PREFIX))
+        return root() + p.substr(4);
+    if (startsWith(p, STORAGE_APP_DATA_PATH_PREFIX))
+        return root() + "/apps_data/host" + p.substr(5);
+    return "";
+}
+
+static FS_Error fromErrno() noexcept
+{
+    switch (errno)
+    {
+    case ENOENT:
+    case ENOTDIR:
+        return FSE_NOT_EXIST;
+    case EEXIST:
+    case ENOTEMPTY:
+        return FSE_EXIST;
+    case EACCES:
+    case EPERM:
+    case EROFS:
+        return FSE_DENIED;
+    case ENAMETOOLONG:
+    case EINVAL:
+        return FSE_INVALID_NAME;
+    default:
+        return FSE_INTERNAL;
+    }
+}
+
+static FS_Error fromErrorCode(const std::error_code& error) noexcept
+{
+    if (!error)
+        return FSE_OK;
+    errno = error.value();
+    return fromErrno();
+}
+
+// Copy fails if the destination exists, merge keeps the files already there
+static FS_Error copyTree(const char* from, const char* to, const bool bMerge) noexcept
+{
+    const std::string source = hostPath(from);
+    const std::string destination = hostPath(to);
+    if (source.empty() || destination.empty())
+        return FSE_INVALID_NAME;
+
+    std::error_code error;
+    if (!fs::exists(source, error))
+        return FSE_NOT_EXIST;
+    if (!bMerge && fs::exists(destination, error))
+        return FSE_EXIST;
+
+    const fs::copy_options options = fs::copy_options::recursive | (bMerge ? fs::copy_options::skip_existing : fs::copy_options::none);
+    fs::copy(source, destination, options, error);
+    return fromErrorCode(error);
+}
+
+extern "C"
+{
+    // Storage is the only record the host has
+    void* furi_record_open(const char* name)
+    {
+        UNUSED(name);
+        return &storage;
+    }
+
+    void furi_record_close(const char* name)
+    {
+        UNUSED(name);
+    }
+
+    bool file_info_is_dir(const FileInfo* fileInfo)
+    {
+        return (fileInfo->flags & FSF_DIRECTORY) != 0;
+    }
+
+    File* storage_file_alloc(Storage* storage)
+    {
+        UNUSED(storage);
+        return new File{ nullptr, nullptr, FSE_OK };
+    }
+
+    void storage_file_free(File* file)
+    {
+        if (file->file != nullptr)
+            fclose(file->file);
+        if (file->dir != nullptr)
+            closedir(file->dir);
+        delete file;
+    }
+
+    bool storage_file_open(File* file, const char* path, const FS_AccessMode accessMode, const FS_OpenMode openMode)
+    {
+        const std::string p = hostPath(path);
+        if (p.empty())
+        {
+            file->error = FSE_INVALID_NAME;
+            return false;
+        }
+
+        const bool bExists = access(p.c_str(), F_OK) == 0;
+        if (openMode == FSOM_OPEN_EXISTING && !bExists)
+        {
+            file->error = FSE_NOT_EXIST;
+            return false;
+        }
+        if (openMode == FSOM_CREATE_NEW && bExists)
+        {
+            file->error = FSE_EXIST;
+            return false;
+        }
+
+        // fopen has no mode that creates without truncating, so create the file first and open it for update
+        if (!bExists && openMode != FSOM_CREATE_ALWAYS)
+        {
+            FILE* created = fopen(p.c_str(), "wb");
+            if (created == nullptr)
+            {
+                file->error = fromErrno();
+                return false;
+            }
+            fclose(created);
+        }
+
+        const bool bWrite = (accessMode & FSAM_WRITE) != 0;
+        const char* mode = "rb";
+        if (openMode == FSOM_CREATE_ALWAYS)
+            mode = (accessMode & FSAM_READ) != 0 ? "w+b" : "wb";
+        else if (openMode == FSOM_OPEN_APPEND)
+            mode = "a+b";
+        else if (bWrite)
+            mode = "r+b";
+
+        file->file = fopen(p.c_str(), mode);
+        file->error = file->file != nullptr ? FSE_OK : fromErrno();
+        return file->file != nullptr;
+    }
+
+    bool storage_file_close(File* file)
+    {
+        if (file->file == nullptr)
+            return false;
+        fclose(file->file);
+        file->file = nullptr;
+        return true;
+    }
+
+    bool storage_file_is_open(File* file)
+    {
+        return file->file != nullptr || file->dir != nullptr;
+    }
+
+    bool storage_file_is_dir(File* file)
+    {
+        return file->dir != nullptr;
+    }
+
+    size_t storage_file_read(File* file, void* buffer, const size_t size)
+    {
+        return file->file != nullptr ? fread(buffer, 1, size, file->file) : 0;
+    }
+
+    size_t storage_file_write(File* file, const void* buffer, const size_t size)
+    {
+        return file->file != nullptr ? fwrite(buffer, 1, size, file->file) : 0;
+    }
+
+    bool storage_file_seek(File* file, const uint32_t offset, const bool bFromStart)
+    {
+        return file->file != nullptr && fseek(file->file, offset, bFromStart ? SEEK_SET : SEEK_CUR) == 0;
+    }
+
+    uint64_t storage_file_tell(File* file)
+    {
+        return file->file != nullptr ? ftell(file->file) : 0;
+    }
+
+    bool storage_file_truncate(File* file)
+    {
+        return file->file != nullptr && fflush(file->file) == 0 && ftruncate(fileno(file->file), ftell(file->file)) == 0;
+    }
+
+    uint64_t storage_file_size(File* file)
+    {
+        struct stat info{};
+        if (file->file == nullptr || fflush(file->file) != 0 || fstat(fileno(file->file), &info) != 0)
+            return 0;
+        return info.st_size;
+    }
+
+    // The card's cache is what a sync pays for, on the host that is fsync
+    bool storage_file_sync(File* file)
+    {
+        return file->file != nullptr && fflush(file->file) == 0 && fsync(fileno(file->file)) == 0;
+    }
+
+    bool storage_file_eof(File* file)
+    {
+        return file->file == nullptr || static_cast<uint64_t>(ftell(file->file)) >= storage_file_size(file);
+    }
+
+    bool storage_file_expand(File* file, const uint64_t size)
+    {
+        if (file->file == nullptr || fflush(file->file) != 0)
+            return false;
+        return size <= storage_file_size(file) || ftruncate(fileno(file->file), static_cast<off_t>(size)) == 0;
+    }
+
+    FS_Error storage_file_get_error(File* file)
+    {
+        return file->error;
+    }
+
+    bool storage_file_copy_to_file(File* source, File* destination, const size_t size)
+    {
+        char buffer[4096];
+        for (size_t copied = 0; copied < size;)
+        {
+            const size_t chunk = size - copied < sizeof(buffer) ? size - copied : sizeof(buffer);
+            const size_t read = storage_file_read(source, buffer, chunk);
+            if (read == 0 || storage_file_write(destination, buffer, read) != read)
+                return false;
+            copied += read;
+        }
+        return true;
+    }
+
+    bool storage_dir_open(File* file, const char* path)
+    {
+        const std::string p = hostPath(path);
+        file->dir = p.empty() ? nullptr : opendir(p.c_str());
+        file->error = p.empty() ? FSE_INVALID_NAME : (file->dir != nullptr ? FSE_OK : fromErrno());
+        return file->dir != nullptr;
+    }
+
+    bool storage_dir_close(File* file)
+    {
+        if (file->dir == nullptr)
+            return false;
+        closedir(file->dir);
+        file->dir = nullptr;
+        return true;
+    }
+
+    bool storage_dir_read(File* file, FileInfo* fileInfo, char* name, const uint16_t nameLength)
+    {
+        if (file->dir == nullptr)
+            return false;
+
+        const dirent* entry;
+        do
+            entry = readdir(file->dir);
+        while (entry != nullptr && (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0));
+
+        if (entry == nullptr)
+        {
+            file->error = FSE_NOT_EXIST;
+            return false;
+        }
+        if (name != nullptr)
+            snprintf(name, nameLength, "%s", entry->d_name);
+        if (fileInfo != nullptr)
+        {
+            fileInfo->flags = entry->d_type == DT_DIR ? FSF_DIRECTORY : 0;
+            fileInfo->size = 0;
+        }
+        return true;
+    }
+
+    bool storage_dir_rewind(File* file)
+    {
+        if (file->dir == nullptr)
+            return false;
+        rewinddir(file->dir);
+        return true;
+    }
+
+    FS_Error storage_common_timestamp(Storage* storage, const char* path, uint32_t* timestamp)
+    {
+        UNUSED(storage);
+        struct stat info{};
+        const std::string p = hostPath(path);
+        if (p.empty())
+            return FSE_INVALID_NAME;
+        if (stat(p.c_str(), &info) != 0)
+            return fromErrno();
+        *timestamp = static_cast<uint32_t>(info.st_mtime);
+        return FSE_OK;
+    }
+
+    FS_Error storage_common_stat(Storage* storage, const char* path, FileInfo* fileInfo)
+    {
+        UNUSED(storage);
+        struct stat info{};
+        const std::string p = hostPath(path);
+        if (p.empty())
+            return FSE_INVALID_NAME;
+        if (stat(p.c_str(), &info) != 0)
+            return fromErrno();
+        if (fileInfo != nullptr)
+        {
+            fileInfo->flags = S_ISDIR(info.st_mode) ? FSF_DIRECTORY : 0;
+            fileInfo->size = S_ISDIR(info.st_mode) ? 0 : info.st_size;
+        }
+        return FSE_OK;
+    }
+
+    bool storage_common_exists(Storage* storage, const char* path)
+    {
+        return storage_common_stat(storage, path, nullptr) == FSE_OK;
+    }
+
+    FS_Error storage_common_remove(Storage* storage, const char* path)
+    {
+        UNUSED(storage);
+        const std::string p = hostPath(path);
+        if (p.empty())
+            return FSE_INVALID_NAME;
+        return ::remove(p.c_str()) == 0 ? FSE_OK : fromErrno();
+    }
+
+    FS_Error storage_common_rename(Storage* storage, const char* oldPath, const char* newPath)
+    {
+        UNUSED(storage);
+        const std::string from = hostPath(oldPath);
+        const std::string to = hostPath(newPath);
+        if (from.empty() || to.empty())
+            return FSE_INVALID_NAME;
+        if (access(to.c_str(), F_OK) == 0)
+            return FSE_EXIST;
+        return ::rename(from.c_str(), to.c_str()) == 0 ? FSE_OK : fromErrno();
+    }
+
+    FS_Error storage_common_copy(Storage* storage, const char* oldPath, const char* newPath)
+    {
+        UNUSED(storage);
+        return copyTree(oldPath, newPath, false);
+    }
+
+    FS_Error storage_common_merge(Storage* storage, const char* oldPath, const char* newPath)
+    {
+        UNUSED(storage);
+        return copyTree(oldPath, newPath, true);
+    }
+
+    FS_Error storage_common_migrate(Storage* storage, const char* source, const char* destination)
+    {
+        const FS_Error error = storage_common_merge(storage, source, destination);
+        if (error != FSE_OK)
+            return error;
+        return storage_simply_remove_recursive(storage, source) ? FSE_OK : FSE_INTERNAL;
+    }
+
+    FS_Error storage_common_mkdir(Storage* storage, const char* path)
+    {
+        UNUSED(storage);
+        const std::string p = hostPath(path);
+        if (p.empty())
+            return FSE_INVALID_NAME;
+        return ::mkdir(p.c_str(), 0755) == 0 ? FSE_OK : fromErrno();
+    }
+
+    FS_Error storage_common_fs_info(Storage* storage, const char* path, uint64_t* totalSpace, uint64_t* freeSpace)
+    {
+        UNUSED(storage);
+        struct statvfs info{};
+        const std::string p = hostPath(path);
+        if (p.empty())
+            return FSE_INVALID_NAME;
+        if (statvfs(p.c_str(), &info) != 0)
+            return fromErrno();
+        if (totalSpace != nullptr)
+            *totalSpace = static_cast<uint64_t>(info.f_blocks) * info.f_frsize;
+        if (freeSpace != nullptr)
+            *freeSpace = static_cast<uint64_t>(info.f_bavail) * info.f_frsize;
+        return FSE_OK;
+    }
+
+    // Maps /data to the host application's folder and creates it, like the real service does for the calling app
+    void storage_common_resolve_path_and_ensure_app_directory(Storage* storage, FuriString* path)
+    {
+        UNUSED(storage);
+        const std::string p = furi_string_get_cstr(path);
+        if (!startsWith(p, STORAGE_APP_DATA_PATH_PREFIX))
+            return;
+
+        furi_string_set_str(path, (STORAGE_EXT_PATH_PREFIX "/apps_data/host" + p.substr(5)).c_str());
+        std::error_code error;
+        fs::create_directories(root() + "/apps_data/host", error);
+    }
+
+    bool storage_common_equivalent_path(Storage* storage, const char* path1, const char* path2)
+    {
+        UNUSED(storage);
+        std::string a = hostPath(path1);
+        std::string b = hostPath(path2);
+        while (a.size() > 1 && a.back() == '/')
+            a.pop_back();
+        while (b.size() > 1 && b.back() == '/')
+            b.pop_back();
+        return !a.empty() && a == b;
+    }
+
+    const char* storage_error_get_desc(const FS_Error error)
+    {
+        static constexpr const char* descriptions[] = { "OK", "filesystem not ready", "file/dir already exist", "file/dir not exist",
+                                                        "invalid parameter", "access denied", "invalid name/path", "internal error",
+                                                        "function not implemented", "file is already open" };
+        return static_cast<size_t>(error) < COUNT_OF(descriptions) ? descriptions[error] : "unknown error";
+    }
+
+    FS_Error storage_sd_info(Storage* storage, SDInfo* info)
+    {
+        uint64_t total = 0;
+        uint64_t free = 0;
+        const FS_Error error = storage_common_fs_info(storage, STORAGE_EXT_PATH_PREFIX, &total, &free);
+        if (error == FSE_OK && info != nullptr)
+        {
+            *info = {};
+            info->kb_total = static_cast<uint32_t>(total >> 10);
+            info->kb_free = static_cast<uint32_t>(free >> 10);
+            info->cluster_size = 4096;
+            info->sector_size = 512;
+        }
+        return error;
+    }
+
+    FS_Error storage_sd_status(Storage* storage)
+    {
+        return storage_common_exists(storage, STORAGE_EXT_PATH_PREFIX) ? FSE_OK : FSE_NOT_READY;
+    }
+
+    bool storage_simply_remove(Storage* storage, const char* path)
+    {
+        const FS_Error error = storage_common_remove(storage, path);
+        return error == FSE_OK || error == FSE_NOT_EXIST;
+    }
+
+    bool storage_simply_remove_recursive(Storage* storage, const char* path)
+    {
+        UNUSED(storage);
+        const std::string p = hostPath(path);
+        if (p.empty())
+            return false;
+        std::error_code error;
+        fs::remove_all(p, error);
+        return !error;
+    }
+
+    bool storage_simply_mkdir(Storage* storage, const char* path)
+    {
+        const FS_Error error = storage_common_mkdir(storage, path);
+        return error == FSE_OK || error == FSE_EXIST;
+    }
+
+    // Sets nextFilename to filename, or filename followed by the first free number, without the directory or extension
+    void storage_get_next_filename(Storage* storage, const char* dirname, const char* filename, const char* fileExtension, FuriString* nextFilename, const uint8_t maxLength)
+    {
+        std::string name = filename;
+        for (uint32_t i = 1; storage_common_exists(storage, (std::string(dirname) + "/" + name + fileExtension).c_str()); i++)
+            name = filename + std::to_string(i);
+        if (maxLength != 0 && name.size() > maxLength)
+            name.resize(maxLength);
+        furi_string_set_str(nextFilename, name.c_str());
+    }
+}
@@ -0,0 +1,64 @@
+// Runs StorageBenchmark against the host's disk through the storage stand-in, for comparison with the numbers a card
+// gives on the device. Only Filesystem.cpp and Benchmark.cpp are linked, the Application and TextBox entry points
+// they call are replaced below.
+//   StorageBenchmark [report path, default /ext/ufz_benchmark.csv]
+#include "../../Benchmark.hpp"
+#include "../../UI.hpp"
+
+#include <cstdio>
+
+// Application is the filesystem's friend, so the replacement can initialise one without an application running
+const UFZ::Filesystem& UFZ::Application::getFilesystem() const noexcept
+{
+    static Filesystem host;
+    static bool bInitialised = false;
+    if (!bInitialised)
+    {
+        host.init();
+        bInitialised = true;
+    }
+    return host;
+}
+
+bool UFZ::Application::runInBackground(const std::function<void()>& job, const std::function<void()>& onDone, const uint32_t loadingScene, const uint32_t loadingDelay) noexcept
+{
+    UNUSED(loadingScene);
+    UNUSED(loadingDelay);
+    job();
+    onDone();
+    return true;
+}
+
+UFZ::Application::~Application() noexcept = default;
+
+const UFZ::TextBox& UFZ::TextBox::setText(const char* text) const noexcept
+{
+    fputs(text, stdout);
+    return *this;
+}
+
+int main(const int argc, const char** argv)
+{
+    UFZ::Application app;
+    UFZ::StorageBenchmark benchmark;
+
+    const char* report = argc > 1 ? argv[1] : STORAGE_EXT_PATH_PREFIX "/ufz_benchmark.csv";
+    const bool bResult = benchmark.run(app.getFilesystem());
+
+    printf("%-10s %6s %8s %10s %8s %8s\n", "test", "block", "ops", "KiB/s", "ops/s", "max us");
+    for (size_t i = 0; i < benchmark.size(); i++)
+    {
+        const auto& a = benchmark.get(i);
+        printf("%-10s %6lu %8lu %10llu %8lu %8lu%s\n", UFZ::StorageBenchmark::getTestName(a.test), static_cast<unsigned long>(a.blockSize),
+               static_cast<unsigned long>(a.operations), static_cast<unsigned long long>(UFZ::StorageBenchmark::getRate(a) >> 10),
+               static_cast<unsigned long>(UFZ::StorageBenchmark::getOperationRate(a)), static_cast<unsigned long>(a.longestMicroseconds), a.bError ? " failed" : "");
+    }
+
+    if (!benchmark.dump(app.getFilesystem(), report))
+    {
+        fprintf(stderr, "Could not write %s\n", report);
+        return 1;
+    }
+    printf("Report written to %s\n", report);
+    return bResult ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+// Runs ThreadPool on the std::thread stand-in. Only ThreadPool.cpp is linked, the two Application entry points it
+// calls are replaced below so completion events are recorded instead of reaching a scene.
+#include "../../ThreadPool.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+static std::mutex eventLock;
+static std::vector<uint32_t> events;
+
+void UFZ::ViewDispatcher::sendCustomEvent(const uint32_t event) const noexcept
+{
+    std::lock_guard lock(eventLock);
+    events.push_back(event);
+}
+
+const UFZ::ViewDispatcher& UFZ::Application::getViewDispatcher() const noexcept
+{
+    return viewDispatcher;
+}
+
+UFZ::Application::~Application() noexcept = default;
+
+#define EXPECT(x) if (!(x)) { fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #x); exit(1); }
+
+static size_t countEvents(const uint32_t event) noexcept
+{
+    std::lock_guard lock(eventLock);
+    size_t result = 0;
+    for (const auto a : events)
+        if (a == event)
+            result++;
+    return result;
+}
+
+static void waitIdle(const UFZ::ThreadPool& pool) noexcept
+{
+    for (uint32_t i = 0; i < 5000 && !pool.isIdle(); i++)
+        furi_delay_ms(1);
+    EXPECT(pool.isIdle());
+}
+
+int main()
+{
+    UFZ::Application app;
+    UFZ::ThreadPool pool;
+
+    // Every element of the range is visited exactly once and the event is sent once
+    {
+        static std::atomic<uint32_t> visits[1000];
+        pool.start(app, 4);
+        EXPECT(pool.parallelFor(0, 1000, 0, [](void*, const uint32_t begin, const uint32_t end) -> void
+        {
+            for (uint32_t i = begin; i < end; i++)
+                visits[i].fetch_add(1);
+        }, nullptr, 1));
+        waitIdle(pool);
+        for (const auto& a : visits)
+            EXPECT(a.load() == 1);
+        EXPECT(countEvents(1) == 1);
+    }
+
+    // Uneven chunks are still all run, and each submit gets its own event
+    {
+        static std::atomic<uint32_t> sum = 0;
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            EXPECT(pool.submit([](void*, uint32_t, uint32_t) -> void
+            {
+                furi_delay_ms(5);
+                sum.fetch_add(1);
+            }, nullptr, 10 + i));
+        }
+        waitIdle(pool);
+        EXPECT(sum.load() == 4);
+        for (uint32_t i = 0; i < 4; i++)
+            EXPECT(countEvents(10 + i) == 1);
+    }
+
+    // Work submitted right before stop() still runs, so the pool is idle afterwards and can be started again
+    for (uint32_t round = 0; round < 200; round++)
+    {
+        static std::atomic<uint32_t> ran = 0;
+        ran = 0;
+        pool.start(app, 1 + round % UFZ::ThreadPool::maxThreads);
+
+        // Lets the workers park in their flag wait, so the work and exit flags tend to arrive together
+        furi_delay_ms(1);
+        EXPECT(pool.parallelFor(0, 32, 1, [](void*, const uint32_t begin, const uint32_t end) -> void
+        {
+            ran.fetch_add(end - begin);
+        }, nullptr, 20));
+        pool.stop();
+        EXPECT(pool.isIdle());
+        EXPECT(ran.load() == 32);
+    }
+    EXPECT(countEvents(20) == 200);
+
+    // Nothing is accepted without workers
+    EXPECT(!pool.submit([](void*, uint32_t, uint32_t) -> void {}, nullptr, 30));
+
+    printf("ThreadPool: all tests passed\n");
+    return 0;
+}
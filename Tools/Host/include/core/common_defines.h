@@ -0,0 +1,3 @@
+#pragma once
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#define FURI_PACKED __attribute__((packed))
@@ -0,0 +1,103 @@
+// Host stand-in for the parts of the Flipper SDK the wrapper's headers use. Only declarations live here, Tools/Host
+// implements the few a host test links against on top of the C++ standard library.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+#define UNUSED(x) (void)(x)
+__attribute__((noreturn)) void __furi_crash(const char*);
+#define furi_crash(msg) __furi_crash(msg)
+#define furi_check(x) ((x) ? (void)0 : __furi_crash("furi_check failed: " #x))
+#define furi_assert(x) furi_check(x)
+#define FURI_LOG_E(tag, ...) do {} while(0)
+#define FURI_LOG_W(tag, ...) do {} while(0)
+#define FURI_LOG_I(tag, ...) do {} while(0)
+#define FURI_LOG_D(tag, ...) do {} while(0)
+#define FuriWaitForever 0xFFFFFFFFU
+typedef enum { FuriStatusOk = 0, FuriStatusError = -1, FuriStatusErrorTimeout = -2 } FuriStatus;
+typedef struct FuriString FuriString;
+FuriString* furi_string_alloc(void);
+FuriString* furi_string_alloc_set_str(const char*);
+void furi_string_free(FuriString*);
+const char* furi_string_get_cstr(const FuriString*);
+void furi_string_set_str(FuriString*, const char*);
+void furi_string_cat_str(FuriString*, const char*);
+void furi_string_cat_printf(FuriString*, const char*, ...);
+void furi_string_reset(FuriString*);
+void furi_string_left(FuriString*, size_t);
+void furi_string_printf(FuriString*, const char*, ...);
+size_t furi_string_size(const FuriString*);
+void furi_string_reserve(FuriString*, size_t);
+void* furi_record_open(const char*);
+void furi_record_close(const char*);
+void* aligned_malloc(size_t size, size_t alignment);
+void aligned_free(void* p);
+size_t memmgr_get_free_heap(void);
+size_t memmgr_get_total_heap(void);
+size_t memmgr_get_minimum_free_heap(void);
+size_t memmgr_heap_get_max_free_block(void);
+uint32_t furi_get_tick(void);
+uint32_t furi_ms_to_ticks(uint32_t ms);
+uint32_t furi_kernel_get_tick_frequency(void);
+void furi_delay_ms(uint32_t);
+void furi_delay_tick(uint32_t);
+bool furi_kernel_is_irq_or_masked(void);
+typedef struct FuriThread FuriThread;
+typedef void* FuriThreadId;
+typedef int32_t (*FuriThreadCallback)(void* context);
+typedef enum { FuriThreadPriorityNone=0, FuriThreadPriorityIdle=1, FuriThreadPriorityLowest=14, FuriThreadPriorityLow=15, FuriThreadPriorityNormal=16, FuriThreadPriorityHigh=17, FuriThreadPriorityHighest=18, FuriThreadPriorityIsr=31 } FuriThreadPriority;
+FuriThread* furi_thread_alloc(void);
+FuriThread* furi_thread_alloc_ex(const char* name, uint32_t stack_size, FuriThreadCallback callback, void* context);
+void furi_thread_free(FuriThread*);
+void furi_thread_set_name(FuriThread*, const char*);
+void furi_thread_set_stack_size(FuriThread*, size_t);
+void furi_thread_set_callback(FuriThread*, FuriThreadCallback);
+void furi_thread_set_context(FuriThread*, void*);
+void furi_thread_set_priority(FuriThread*, FuriThreadPriority);
+void furi_thread_start(FuriThread*);
+bool furi_thread_join(FuriThread*);
+FuriThreadId furi_thread_get_id(FuriThread*);
+FuriThreadId furi_thread_get_current_id(void);
+const char* furi_thread_get_appid(FuriThreadId);
+uint32_t furi_thread_get_stack_space(FuriThreadId);
+const char* furi_thread_get_name(FuriThreadId);
+uint32_t furi_thread_flags_set(FuriThreadId, uint32_t);
+uint32_t furi_thread_flags_wait(uint32_t, uint32_t, uint32_t);
+uint32_t furi_thread_flags_clear(uint32_t);
+#define FuriFlagWaitAny 0
+#define FuriFlagWaitAll 1
+#define FuriFlagNoClear 2
+#define FuriFlagError 0x80000000U
+#define FuriFlagErrorTimeout 0xFFFFFFFEU
+typedef struct FuriMutex FuriMutex;
+typedef enum { FuriMutexTypeNormal, FuriMutexTypeRecursive } FuriMutexType;
+FuriMutex* furi_mutex_alloc(FuriMutexType);
+void furi_mutex_free(FuriMutex*);
+FuriStatus furi_mutex_acquire(FuriMutex*, uint32_t);
+FuriStatus furi_mutex_release(FuriMutex*);
+typedef struct FuriSemaphore FuriSemaphore;
+FuriSemaphore* furi_semaphore_alloc(uint32_t max, uint32_t initial);
+void furi_semaphore_free(FuriSemaphore*);
+FuriStatus furi_semaphore_acquire(FuriSemaphore*, uint32_t);
+FuriStatus furi_semaphore_release(FuriSemaphore*);
+typedef struct FuriMessageQueue FuriMessageQueue;
+FuriMessageQueue* furi_message_queue_alloc(uint32_t, uint32_t);
+void furi_message_queue_free(FuriMessageQueue*);
+FuriStatus furi_message_queue_put(FuriMessageQueue*, const void*, uint32_t);
+FuriStatus furi_message_queue_get(FuriMessageQueue*, void*, uint32_t);
+typedef struct FuriTimer FuriTimer;
+typedef void (*FuriTimerCallback)(void* context);
+typedef enum { FuriTimerTypeOnce, FuriTimerTypePeriodic } FuriTimerType;
+FuriTimer* furi_timer_alloc(FuriTimerCallback, FuriTimerType, void*);
+void furi_timer_free(FuriTimer*);
+FuriStatus furi_timer_start(FuriTimer*, uint32_t);
+FuriStatus furi_timer_stop(FuriTimer*);
+#ifdef __cplusplus
+}
+#endif
+#include <core/common_defines.h>
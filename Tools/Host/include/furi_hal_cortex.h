@@ -0,0 +1,9 @@
+#pragma once
+#include <furi.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+#include <furi.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef enum { ColorWhite = 0, ColorBlack = 1, ColorXOR = 2 } Color;
+typedef enum { FontPrimary, FontSecondary, FontKeyboard, FontBigNumbers, FontTotalNumber } Font;
+typedef enum { AlignLeft, AlignRight, AlignTop, AlignBottom, AlignCenter } Align;
+typedef struct Canvas Canvas;
+void canvas_clear(Canvas*);
+void canvas_set_color(Canvas*, Color);
+void canvas_set_font(Canvas*, Font);
+void canvas_draw_str(Canvas*, int32_t, int32_t, const char*);
+void canvas_draw_str_aligned(Canvas*, int32_t, int32_t, Align, Align, const char*);
+uint16_t canvas_string_width(Canvas*, const char*);
+uint16_t canvas_glyph_width(Canvas*, uint16_t);
+size_t canvas_current_font_height(const Canvas*);
+size_t canvas_width(const Canvas*);
+size_t canvas_height(const Canvas*);
+void canvas_draw_box(Canvas*, int32_t, int32_t, size_t, size_t);
+void canvas_draw_frame(Canvas*, int32_t, int32_t, size_t, size_t);
+void canvas_draw_line(Canvas*, int32_t, int32_t, int32_t, int32_t);
+void canvas_draw_dot(Canvas*, int32_t, int32_t);
+void canvas_draw_icon(Canvas*, int32_t, int32_t, const Icon*);
+void canvas_draw_xbm(Canvas*, int32_t, int32_t, size_t, size_t, const uint8_t*);
+void canvas_invert_color(Canvas*);
+void canvas_draw_rbox(Canvas*, int32_t, int32_t, size_t, size_t, size_t);
+void canvas_draw_rframe(Canvas*, int32_t, int32_t, size_t, size_t, size_t);
+#ifdef __cplusplus
+}
+#endif
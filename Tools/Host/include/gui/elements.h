@@ -0,0 +1,14 @@
+#pragma once
+#include <gui/canvas.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+void elements_scrollbar(Canvas*, size_t, size_t);
+void elements_scrollbar_pos(Canvas*, int32_t, int32_t, size_t, size_t, size_t);
+void elements_frame(Canvas*, int32_t, int32_t, size_t, size_t);
+void elements_button_left(Canvas*, const char*);
+void elements_button_right(Canvas*, const char*);
+void elements_button_center(Canvas*, const char*);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,4 @@
+#pragma once
+#include <gui/view.h>
+#define RECORD_GUI "gui"
+typedef struct Gui Gui;
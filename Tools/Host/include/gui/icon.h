@@ -0,0 +1,13 @@
+#pragma once
+#include <furi.h>
+typedef struct Icon Icon;
+#ifdef __cplusplus
+extern "C" {
+#endif
+uint16_t icon_get_width(const Icon*);
+uint16_t icon_get_height(const Icon*);
+const uint8_t* icon_get_frame_data(const Icon*, uint32_t);
+uint32_t icon_get_frame_count(const Icon*);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,3 @@
+#pragma once
+#include <gui/icon.h>
+struct Icon { const uint16_t width; const uint16_t height; const uint8_t frame_count; const uint8_t frame_rate; const uint8_t* const* frames; };
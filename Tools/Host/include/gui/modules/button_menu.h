@@ -0,0 +1,15 @@
+#pragma once
+#include <gui/view.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct ButtonMenu ButtonMenu; typedef struct ButtonMenuItem ButtonMenuItem;
+typedef enum { ButtonMenuItemTypeCommon, ButtonMenuItemTypeControl } ButtonMenuItemType;
+typedef void (*ButtonMenuItemCallback)(void*, int32_t, InputType);
+ButtonMenu* button_menu_alloc(void); void button_menu_free(ButtonMenu*); View* button_menu_get_view(ButtonMenu*); void button_menu_reset(ButtonMenu*);
+ButtonMenuItem* button_menu_add_item(ButtonMenu*, const char*, int32_t, ButtonMenuItemCallback, ButtonMenuItemType, void*);
+void button_menu_set_header(ButtonMenu*, const char*); void button_menu_set_selected_item(ButtonMenu*, uint32_t);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+#include <gui/view.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct ButtonPanel ButtonPanel; typedef void (*ButtonItemCallback)(void*, uint32_t);
+ButtonPanel* button_panel_alloc(void); void button_panel_free(ButtonPanel*); View* button_panel_get_view(ButtonPanel*); void button_panel_reset(ButtonPanel*);
+void button_panel_reserve(ButtonPanel*, size_t, size_t);
+void button_panel_add_item(ButtonPanel*, uint32_t, uint16_t, uint16_t, uint16_t, uint16_t, const Icon*, const Icon*, ButtonItemCallback, void*);
+void button_panel_add_label(ButtonPanel*, uint16_t, uint16_t, Font, const char*);
+void button_panel_add_icon(ButtonPanel*, uint16_t, uint16_t, const Icon*);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,13 @@
+#pragma once
+#include <gui/view.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct ByteInput ByteInput; typedef void (*ByteInputCallback)(void*); typedef void (*ByteChangedCallback)(void*);
+ByteInput* byte_input_alloc(void); void byte_input_free(ByteInput*); View* byte_input_get_view(ByteInput*);
+void byte_input_set_result_callback(ByteInput*, ByteInputCallback, ByteChangedCallback, void*, uint8_t*, uint8_t);
+void byte_input_set_header_text(ByteInput*, const char*);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+#include <gui/view.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct DialogEx DialogEx; typedef enum { DialogExResultLeft, DialogExResultCenter, DialogExResultRight } DialogExResult;
+typedef void (*DialogExResultCallback)(DialogExResult, void*);
+DialogEx* dialog_ex_alloc(void); void dialog_ex_free(DialogEx*); View* dialog_ex_get_view(DialogEx*); void dialog_ex_reset(DialogEx*);
+void dialog_ex_set_result_callback(DialogEx*, DialogExResultCallback); void dialog_ex_set_context(DialogEx*, void*);
+void dialog_ex_set_header(DialogEx*, const char*, uint8_t, uint8_t, Align, Align);
+void dialog_ex_set_text(DialogEx*, const char*, uint8_t, uint8_t, Align, Align);
+void dialog_ex_set_icon(DialogEx*, uint8_t, uint8_t, const Icon*);
+void dialog_ex_set_left_button_text(DialogEx*, const char*); void dialog_ex_set_center_button_text(DialogEx*, const char*); void dialog_ex_set_right_button_text(DialogEx*, const char*);
+void dialog_ex_enable_extended_events(DialogEx*); void dialog_ex_disable_extended_events(DialogEx*);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,10 @@
+#pragma once
+#include <gui/view.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct EmptyScreen EmptyScreen; EmptyScreen* empty_screen_alloc(void); void empty_screen_free(EmptyScreen*); View* empty_screen_get_view(EmptyScreen*);
+#ifdef __cplusplus
+}
+#endif
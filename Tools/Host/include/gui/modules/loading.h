@@ -0,0 +1,10 @@
+#pragma once
+#include <gui/view.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct Loading Loading; Loading* loading_alloc(void); void loading_free(Loading*); View* loading_get_view(Loading*);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,13 @@
+#pragma once
+#include <gui/view.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct Menu Menu; typedef void (*MenuItemCallback)(void*, uint32_t);
+Menu* menu_alloc(void); void menu_free(Menu*); View* menu_get_view(Menu*); void menu_reset(Menu*);
+void menu_add_item(Menu*, const char*, const Icon*, uint32_t, MenuItemCallback, void*);
+void menu_set_selected_item(Menu*, uint32_t);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,13 @@
+#pragma once
+#include <gui/view.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct NumberInput NumberInput; typedef void (*NumberInputCallback)(void*, int32_t);
+NumberInput* number_input_alloc(void); void number_input_free(NumberInput*); View* number_input_get_view(NumberInput*);
+void number_input_set_result_callback(NumberInput*, NumberInputCallback, void*, int32_t, int32_t, int32_t);
+void number_input_set_header_text(NumberInput*, const char*);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+#include <gui/view.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct Popup Popup; typedef void (*PopupCallback)(void*);
+Popup* popup_alloc(void); void popup_free(Popup*); View* popup_get_view(Popup*); void popup_reset(Popup*);
+void popup_set_callback(Popup*, PopupCallback); void popup_set_context(Popup*, void*);
+void popup_set_header(Popup*, const char*, uint8_t, uint8_t, Align, Align); void popup_set_text(Popup*, const char*, uint8_t, uint8_t, Align, Align);
+void popup_set_icon(Popup*, uint8_t, uint8_t, const Icon*); void popup_set_timeout(Popup*, uint32_t);
+void popup_enable_timeout(Popup*); void popup_disable_timeout(Popup*);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,14 @@
+#pragma once
+#include <gui/view.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct Submenu Submenu; typedef void (*SubmenuItemCallback)(void*, uint32_t);
+Submenu* submenu_alloc(void); void submenu_free(Submenu*); View* submenu_get_view(Submenu*); void submenu_reset(Submenu*);
+void submenu_add_item(Submenu*, const char*, uint32_t, SubmenuItemCallback, void*);
+void submenu_change_item_label(Submenu*, uint32_t, const char*);
+void submenu_set_selected_item(Submenu*, uint32_t); uint32_t submenu_get_selected_item(Submenu*); void submenu_set_header(Submenu*, const char*);
+#ifdef __cplusplus
+}
+#endif
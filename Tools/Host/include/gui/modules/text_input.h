@@ -0,0 +1,14 @@
+#pragma once
+#include <gui/view.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct TextInput TextInput; typedef void (*TextInputCallback)(void*); typedef bool (*TextInputValidatorCallback)(const char*, FuriString*, void*);
+TextInput* text_input_alloc(void); void text_input_free(TextInput*); View* text_input_get_view(TextInput*); void text_input_reset(TextInput*);
+void text_input_set_result_callback(TextInput*, TextInputCallback, void*, char*, size_t, bool);
+void text_input_set_validator(TextInput*, TextInputValidatorCallback, void*); void* text_input_get_validator_callback_context(TextInput*);
+void text_input_set_header_text(TextInput*, const char*);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+#include <gui/view.h>
+#include <gui/icon.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct Widget Widget; typedef enum { GuiButtonTypeLeft, GuiButtonTypeCenter, GuiButtonTypeRight } GuiButtonType;
+typedef void (*ButtonCallback)(GuiButtonType, InputType, void*);
+Widget* widget_alloc(void); void widget_free(Widget*); View* widget_get_view(Widget*); void widget_reset(Widget*);
+void widget_add_string_multiline_element(Widget*, uint8_t, uint8_t, Align, Align, Font, const char*);
+void widget_add_string_element(Widget*, uint8_t, uint8_t, Align, Align, Font, const char*);
+void widget_add_text_box_element(Widget*, uint8_t, uint8_t, uint8_t, uint8_t, Align, Align, const char*, bool);
+void widget_add_text_scroll_element(Widget*, uint8_t, uint8_t, uint8_t, uint8_t, const char*);
+void widget_add_button_element(Widget*, GuiButtonType, const char*, ButtonCallback, void*);
+void widget_add_icon_element(Widget*, uint8_t, uint8_t, const Icon*);
+void widget_add_frame_element(Widget*, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t);
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+#include <gui/canvas.h>
+#include <input/input.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct View View;
+typedef enum { ViewOrientationHorizontal, ViewOrientationVertical } ViewOrientation;
+typedef enum { ViewModelTypeNone, ViewModelTypeLockFree, ViewModelTypeLocking } ViewModelType;
+typedef void (*ViewDrawCallback)(Canvas*, void*);
+typedef bool (*ViewInputCallback)(InputEvent*, void*);
+typedef bool (*ViewCustomCallback)(uint32_t, void*);
+typedef uint32_t (*ViewNavigationCallback)(void*);
+typedef void (*ViewCallback)(void*);
+typedef void (*ViewUpdateCallback)(View*, void*);
+View* view_alloc(void);
+void view_free(View*);
+void view_set_draw_callback(View*, ViewDrawCallback);
+void view_set_input_callback(View*, ViewInputCallback);
+void view_set_custom_callback(View*, ViewCustomCallback);
+void view_set_previous_callback(View*, ViewNavigationCallback);
+void view_set_enter_callback(View*, ViewCallback);
+void view_set_exit_callback(View*, ViewCallback);
+void view_set_update_callback(View*, ViewUpdateCallback);
+void view_set_update_callback_context(View*, void*);
+void view_set_context(View*, void*);
+void view_set_orientation(View*, ViewOrientation);
+void view_allocate_model(View*, ViewModelType, size_t);
+void view_free_model(View*);
+void* view_get_model(View*);
+void view_commit_model(View*, bool);
+#ifdef __cplusplus
+}
+#endif
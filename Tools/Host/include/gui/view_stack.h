@@ -0,0 +1,12 @@
+#pragma once
+#include <gui/view.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct ViewStack ViewStack;
+ViewStack* view_stack_alloc(void); void view_stack_free(ViewStack*);
+View* view_stack_get_view(ViewStack*);
+void view_stack_add_view(ViewStack*, View*); void view_stack_remove_view(ViewStack*, View*);
+#ifdef __cplusplus
+}
+#endif
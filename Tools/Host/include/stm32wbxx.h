@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+
+// Only the cycle counter of the CMSIS core registers. Reading it samples the host's steady clock at
+// furi_hal_cortex_instructions_per_microsecond() cycles per microsecond, so it wraps like the device's.
+extern "C" uint32_t host_cycle_counter(void);
+
+typedef struct
+{
+    struct Counter
+    {
+        operator uint32_t() const { return host_cycle_counter(); }
+    };
+
+    volatile uint32_t CTRL;
+    Counter CYCCNT;
+} DWT_Type;
+
+static DWT_Type hostDWT;
+#define DWT (&hostDWT)
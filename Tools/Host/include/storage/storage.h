@@ -0,0 +1,65 @@
+#pragma once
+#include <furi.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+#define RECORD_STORAGE "storage"
+#define EXT_PATH(p) "/ext/" p
+#define APP_DATA_PATH(p) "/data/" p
+#define STORAGE_EXT_PATH_PREFIX "/ext"
+#define STORAGE_APP_DATA_PATH_PREFIX "/data"
+#define STORAGE_INT_PATH_PREFIX "/int"
+#define STORAGE_ANY_PATH_PREFIX "/any"
+#define STORAGE_APP_ASSETS_PATH_PREFIX "/assets"
+typedef struct Storage Storage;
+typedef struct File File;
+typedef enum { FSE_OK, FSE_NOT_READY, FSE_EXIST, FSE_NOT_EXIST, FSE_INVALID_PARAMETER, FSE_DENIED, FSE_INVALID_NAME, FSE_INTERNAL, FSE_NOT_IMPLEMENTED, FSE_ALREADY_OPEN } FS_Error;
+typedef enum { FSAM_READ = 1, FSAM_WRITE = 2, FSAM_READ_WRITE = 3 } FS_AccessMode;
+typedef enum { FSOM_OPEN_EXISTING = 1, FSOM_OPEN_ALWAYS = 2, FSOM_OPEN_APPEND = 4, FSOM_CREATE_NEW = 8, FSOM_CREATE_ALWAYS = 16 } FS_OpenMode;
+typedef enum { FSF_DIRECTORY = 1 } FS_Flags;
+typedef struct { uint32_t flags; uint64_t size; } FileInfo;
+typedef struct { uint8_t fs_type; uint32_t kb_total; uint32_t kb_free; uint16_t cluster_size; uint16_t sector_size; } SDInfo;
+bool file_info_is_dir(const FileInfo*);
+File* storage_file_alloc(Storage*);
+void storage_file_free(File*);
+bool storage_file_open(File*, const char*, FS_AccessMode, FS_OpenMode);
+bool storage_file_close(File*);
+bool storage_file_is_open(File*);
+bool storage_file_is_dir(File*);
+size_t storage_file_read(File*, void*, size_t);
+size_t storage_file_write(File*, const void*, size_t);
+bool storage_file_seek(File*, uint32_t, bool);
+uint64_t storage_file_tell(File*);
+bool storage_file_truncate(File*);
+uint64_t storage_file_size(File*);
+bool storage_file_sync(File*);
+bool storage_file_eof(File*);
+bool storage_file_expand(File*, uint64_t);
+FS_Error storage_file_get_error(File*);
+bool storage_file_copy_to_file(File*, File*, size_t);
+bool storage_dir_open(File*, const char*);
+bool storage_dir_close(File*);
+bool storage_dir_read(File*, FileInfo*, char*, uint16_t);
+bool storage_dir_rewind(File*);
+FS_Error storage_common_timestamp(Storage*, const char*, uint32_t*);
+FS_Error storage_common_stat(Storage*, const char*, FileInfo*);
+bool storage_common_exists(Storage*, const char*);
+FS_Error storage_common_remove(Storage*, const char*);
+FS_Error storage_common_rename(Storage*, const char*, const char*);
+FS_Error storage_common_copy(Storage*, const char*, const char*);
+FS_Error storage_common_merge(Storage*, const char*, const char*);
+FS_Error storage_common_migrate(Storage*, const char*, const char*);
+FS_Error storage_common_mkdir(Storage*, const char*);
+FS_Error storage_common_fs_info(Storage*, const char*, uint64_t*, uint64_t*);
+void storage_common_resolve_path_and_ensure_app_directory(Storage*, FuriString*);
+bool storage_common_equivalent_path(Storage*, const char*, const char*);
+const char* storage_error_get_desc(FS_Error);
+FS_Error storage_sd_info(Storage*, SDInfo*);
+FS_Error storage_sd_status(Storage*);
+bool storage_simply_remove(Storage*, const char*);
+bool storage_simply_remove_recursive(Storage*, const char*);
+bool storage_simply_mkdir(Storage*, const char*);
+void storage_get_next_filename(Storage*, const char*, const char*, const char*, FuriString*, uint8_t);
+#ifdef __cplusplus
+}
+#endif
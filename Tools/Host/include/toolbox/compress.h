@@ -0,0 +1,12 @@
+#pragma once
+#include <furi.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+typedef struct CompressIcon CompressIcon;
+CompressIcon* compress_icon_alloc(size_t decode_buf_size);
+void compress_icon_free(CompressIcon*);
+void compress_icon_decode(CompressIcon*, const uint8_t* icon_data, uint8_t** output);
+#ifdef __cplusplus
+}
+#endif
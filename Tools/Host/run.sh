@@ -0,0 +1,21 @@
+#!/bin/sh
+# Builds the host tests and the storage benchmark against the SDK stand-in in include/ and runs them, from any
+# directory:
+#   Tools/Host/run.sh
+# /ext is a directory under $TMPDIR unless UFZ_HOST_EXT points somewhere else, e.g. at a mounted card for comparison.
+set -e
+HOST="$(cd "$(dirname "$0")" && pwd)"
+ROOT="$HOST/../.."
+OUT="${TMPDIR:-/tmp}/ufz-host"
+CXX="${CXX:-g++}"
+FLAGS="-std=c++20 -fno-exceptions -fno-rtti -O2 -g -Wall -Wextra -I$HOST/include"
+
+export UFZ_HOST_EXT="${UFZ_HOST_EXT:-$OUT/ext}"
+mkdir -p "$OUT" "$UFZ_HOST_EXT"
+
+$CXX $FLAGS -pthread -o "$OUT/ThreadPoolTest" "$HOST/ThreadPoolTest.cpp" "$ROOT/ThreadPool.cpp" "$HOST/Furi.cpp"
+$CXX $FLAGS -pthread -o "$OUT/StorageBenchmark" "$HOST/StorageBenchmark.cpp" "$ROOT/Benchmark.cpp" "$ROOT/Filesystem.cpp" \
+    "$HOST/Furi.cpp" "$HOST/Storage.cpp"
+
+"$OUT/ThreadPoolTest"
+"$OUT/StorageBenchmark"
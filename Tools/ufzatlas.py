@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""Builds an icon atlas for UFZ::IconAtlas from images.
+
+    ufzatlas.py out.atlas icons/Battery.png icons/Spinner/ --frame-rate 4
+
+A file is a single frame icon, a directory an animated one whose frames are its images in name order, the same layout
+the firmware's assets use. A frame_rate file in the directory overrides --frame-rate. Icons are named by their file or
+directory name without the extension and keep the order they are given in, which is their index. Dark, opaque pixels
+are set.
+
+PBM images (P1 and P4) are read directly, anything else needs Pillow. See IconAtlas in UI.hpp for the layout.
+"""
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = 0x415A4655  # "UFZA"
+VERSION = 1
+NAME_SIZE = 16
+HEADER = struct.Struct("<IHH")
+RECORD = struct.Struct(f"<{NAME_SIZE}sHHBBHI")
+
+
+def pbm_tokens(data):
+    position = 0
+    while True:
+        while position < len(data) and (data[position:position + 1].isspace() or data[position:position + 1] == b"#"):
+            if data[position:position + 1] == b"#":
+                while position < len(data) and data[position:position + 1] != b"\n":
+                    position += 1
+            else:
+                position += 1
+        start = position
+        while position < len(data) and not data[position:position + 1].isspace():
+            position += 1
+        if start == position:
+            return
+        yield data[start:position], position
+
+
+def read_pbm(path, data):
+    tokens = pbm_tokens(data)
+    kind, _ = next(tokens)
+    width = int(next(tokens)[0])
+    height, end = next(tokens)
+    height = int(height)
+
+    rows = []
+    if kind == b"P4":
+        stride = (width + 7) // 8
+        body = data[end + 1:end + 1 + stride * height]
+        if len(body) != stride * height:
+            sys.exit(f"ufzatlas: {path} is truncated")
+        for y in range(height):
+            row = body[y * stride:(y + 1) * stride]
+            rows.append([(row[x // 8] >> (7 - x % 8)) & 1 for x in range(width)])
+    else:
+        bits = [int(bit) for token, _ in tokens if token for bit in token.decode("ascii")]
+        if len(bits) < width * height:
+            sys.exit(f"ufzatlas: {path} is truncated")
+        rows = [bits[y * width:(y + 1) * width] for y in range(height)]
+    return width, height, rows
+
+
+def read_image(path):
+    with open(path, "rb") as file:
+        data = file.read()
+    if data[:2] in (b"P1", b"P4"):
+        return read_pbm(path, data)
+
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit(f"ufzatlas: {path} is not a PBM image and Pillow is not installed")
+
+    image = Image.open(path).convert("RGBA")
+    width, height = image.size
+    pixels = image.load()
+    rows = []
+    for y in range(height):
+        row = []
+        for x in range(width):
+            r, g, b, a = pixels[x, y]
+            row.append(1 if a >= 128 and r * 299 + g * 587 + b * 114 < 128000 else 0)
+        rows.append(row)
+    return width, height, rows
+
+
+# XBM, least significant bit first, preceded by the zero byte that marks a frame as not compressed
+def encode_frame(width, rows):
+    frame = bytearray(b"\0")
+    for row in rows:
+        for x in range(0, width, 8):
+            byte = 0
+            for bit, pixel in enumerate(row[x:x + 8]):
+                byte |= pixel << bit
+            frame.append(byte)
+    return bytes(frame)
+
+
+def load_icon(path, frame_rate):
+    if os.path.isdir(path):
+        files = sorted(name for name in os.listdir(path) if name != "frame_rate" and not name.startswith("."))
+        rate_path = os.path.join(path, "frame_rate")
+        if os.path.isfile(rate_path):
+            with open(rate_path) as file:
+                frame_rate = int(file.read().strip())
+        name = os.path.basename(os.path.normpath(path))
+    elif os.path.isfile(path):
+        files = [path]
+        frame_rate = 0
+        name = os.path.splitext(os.path.basename(path))[0]
+    else:
+        sys.exit(f"ufzatlas: {path} does not exist")
+
+    if not files:
+        sys.exit(f"ufzatlas: {path} has no frames")
+    if len(files) > 0xFF or not 0 <= frame_rate <= 0xFF:
+        sys.exit(f"ufzatlas: {path} needs at most 255 frames and a frame rate below 256")
+
+    frames = []
+    size = None
+    for file in files:
+        width, height, rows = read_image(os.path.join(path, file) if os.path.isdir(path) else file)
+        if size is not None and size != (width, height):
+            sys.exit(f"ufzatlas: the frames of {path} differ in size")
+        if width == 0 or height == 0 or width > 0xFFFF or height > 0xFFFF:
+            sys.exit(f"ufzatlas: {path} has an invalid size")
+        size = (width, height)
+        frames.append(encode_frame(width, rows))
+
+    encoded = name.encode("utf-8")
+    if not encoded or len(encoded) > NAME_SIZE:
+        sys.exit(f"ufzatlas: the name {name} must be 1 to {NAME_SIZE} bytes")
+    return encoded, size[0], size[1], frame_rate, frames
+
+
+def build(icons):
+    if len(icons) > 0xFFFF:
+        sys.exit("ufzatlas: an atlas holds at most 65535 icons")
+
+    offset = HEADER.size + RECORD.size * len(icons)
+    records = bytearray()
+    blobs = bytearray()
+    for name, width, height, frame_rate, frames in icons:
+        records += RECORD.pack(name, width, height, len(frames), frame_rate, 0, offset)
+        for frame in frames:
+            blobs += frame
+            offset += len(frame)
+        if offset > 0xFFFFFFFF:
+            sys.exit("ufzatlas: the atlas would be larger than 4 GiB")
+    return HEADER.pack(MAGIC, VERSION, len(icons)) + records + blobs
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Builds an icon atlas for UFZ::IconAtlas")
+    parser.add_argument("output")
+    parser.add_argument("inputs", nargs="+", help="images, or directories of frames for animated icons")
+    parser.add_argument("--frame-rate", type=int, default=4, help="frames per second of animated icons (default 4)")
+    args = parser.parse_args()
+
+    icons = [load_icon(path, args.frame_rate) for path in args.inputs]
+    seen = set()
+    for name, *_ in icons:
+        if name in seen:
+            sys.exit(f"ufzatlas: more than one icon is named {name.decode('utf-8')}")
+        seen.add(name)
+
+    with open(args.output, "wb") as file:
+        file.write(build(icons))
+    print(f"ufzatlas: {len(icons)} icons written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Builds a pack archive for UFZ::PackReader from files and directories.
+
+    ufzpack.py out.pack assets/ extra/config.bin --align 16
+
+Directories are added recursively and their entries are named by their path relative to the directory, files by their
+file name. Names use forward slashes and must be unique. See PackReader in Filesystem.hpp for the layout.
+"""
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = 0x505A4655  # "UFZP"
+VERSION = 1
+HEADER = struct.Struct("<IHHII")
+RECORD = struct.Struct("<IIII")
+
+
+def fnv1a(name: bytes) -> int:
+    result = 2166136261
+    for byte in name:
+        result ^= byte
+        result = (result * 16777619) & 0xFFFFFFFF
+    return result
+
+
+def collect(inputs):
+    entries = {}
+
+    # Two inputs with the same name would leave one of them silently out of the pack
+    def add(name, path):
+        if name in entries:
+            sys.exit(f"ufzpack: {path} and {entries[name]} are both named {name}")
+        entries[name] = path
+
+    for path in inputs:
+        if os.path.isdir(path):
+            for root, _, files in os.walk(path):
+                for file in files:
+                    full = os.path.join(root, file)
+                    add(os.path.relpath(full, path).replace(os.sep, "/"), full)
+        elif os.path.isfile(path):
+            add(os.path.basename(path), path)
+        else:
+            sys.exit(f"ufzpack: {path} does not exist")
+    return entries
+
+
+def build(entries, alignment):
+    names = sorted((name.encode("utf-8") for name in entries), key=lambda name: (fnv1a(name), name))
+    table = bytearray()
+    name_offsets = []
+    for name in names:
+        name_offsets.append(len(table))
+        table += name + b"\0"
+
+    def align(value):
+        return (value + alignment - 1) // alignment * alignment
+
+    offset = align(HEADER.size + RECORD.size * len(names) + len(table))
+    records = bytearray()
+    blobs = bytearray()
+    for name, name_offset in zip(names, name_offsets):
+        with open(entries[name.decode("utf-8")], "rb") as file:
+            data = file.read()
+        if offset + len(data) > 0xFFFFFFFF:
+            sys.exit("ufzpack: the pack would be larger than 4 GiB")
+        records += RECORD.pack(fnv1a(name), name_offset, offset, len(data))
+        blobs += data + bytes(align(len(data)) - len(data))
+        offset += align(len(data))
+
+    body = HEADER.pack(MAGIC, VERSION, alignment, len(names), len(table)) + records + table
+    return body + bytes(align(len(body)) - len(body)) + blobs
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Builds a pack archive for UFZ::PackReader")
+    parser.add_argument("output")
+    parser.add_argument("inputs", nargs="+", help="files and directories to pack")
+    parser.add_argument("--align", type=int, default=16, help="blob alignment in bytes, a power of two (default 16)")
+    args = parser.parse_args()
+
+    if args.align <= 0 or args.align & (args.align - 1) or args.align > 0xFFFF:
+        sys.exit("ufzpack: --align must be a power of two below 65536")
+
+    entries = collect(args.inputs)
+    with open(args.output, "wb") as file:
+        file.write(build(entries, args.align))
+    print(f"ufzpack: {len(entries)} entries written to {args.output}")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,4 +1,5 @@
 #include "UI.hpp"
+#include <cstdarg>
 
 // =====================================================================================================================
 // ======================================================= Views =======================================================
@@ -177,6 +178,22 @@ const UFZ::Menu& UFZ::Menu::addItem(const char* label, const Icon* icon, const u
     return *this;
 }
 
+const UFZ::Menu& UFZ::Menu::addItems(const std::span<const Item> items) const noexcept
+{
+    for (const auto& a : items)
+        menu_add_item(menu, a.label, a.icon, a.index, a.callback, a.context);
+    return *this;
+}
+
+const UFZ::Menu& UFZ::Menu::clearAndRepopulate(const std::span<const Item> items, const uint32_t selected) noexcept
+{
+    reset();
+    addItems(items);
+    if (selected < items.size())
+        setSelectedItem(selected);
+    return *this;
+}
+
 void UFZ::Menu::setSelectedItem(const uint32_t index) const noexcept
 {
     menu_set_selected_item(menu, index);
@@ -191,6 +208,29 @@ ButtonMenuItem* UFZ::ButtonMenu::addItem(const char* label, const int32_t index,
     return button_menu_add_item(button_menu, label, index, callback, type, context);
 }
 
+const UFZ::ButtonMenu& UFZ::ButtonMenu::addItems(const std::span<const Item> items, const std::span<ButtonMenuItem*> result) const noexcept
+{
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        const auto& a = items[i];
+        ButtonMenuItem* item = button_menu_add_item(button_menu, a.label, a.index, a.callback, a.type, a.context);
+        if (i < result.size())
+            result[i] = item;
+    }
+    return *this;
+}
+
+const UFZ::ButtonMenu& UFZ::ButtonMenu::clearAndRepopulate(const std::span<const Item> items, const uint32_t selected, const std::span<ButtonMenuItem*> result) noexcept
+{
+    reset();
+    addItems(items, result);
+
+    // button_menu_set_selected_item takes an item index, not a position
+    if (selected < items.size())
+        setSelectedItem(static_cast<uint32_t>(items[selected].index));
+    return *this;
+}
+
 void UFZ::ButtonMenu::setHeader(const char* header) const noexcept
 {
     button_menu_set_header(button_menu, header);
@@ -473,6 +513,26 @@ const UFZ::Submenu& UFZ::Submenu::addItem(const char* label, const uint32_t inde
     return *this;
 }
 
+const UFZ::Submenu& UFZ::Submenu::addItems(const std::span<const Item> items) const noexcept
+{
+    for (const auto& a : items)
+        submenu_add_item(submenu, a.label, a.index, a.callback, a.context);
+    return *this;
+}
+
+const UFZ::Submenu& UFZ::Submenu::clearAndRepopulate(const std::span<const Item> items, const uint32_t selected, const char* header) noexcept
+{
+    reset();
+    if (header != nullptr)
+        setHeader(header);
+    addItems(items);
+
+    // submenu_set_selected_item takes an item index, not a position
+    if (selected < items.size())
+        setSelectedItem(items[selected].index);
+    return *this;
+}
+
 const UFZ::Submenu& UFZ::Submenu::setSelectedItem(const uint32_t index) const noexcept
 {
     submenu_set_selected_item(submenu, index);
@@ -540,6 +600,27 @@ VariableItem* UFZ::VariableItemList::add(const char* label, const uint8_t values
     return variable_item_list_add(variable_item_list, label, values_count, callback, context);
 }
 
+const UFZ::VariableItemList& UFZ::VariableItemList::addItems(const std::span<const Item> items, const std::span<VariableItem*> result) const noexcept
+{
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        const auto& a = items[i];
+        VariableItem* item = variable_item_list_add(variable_item_list, a.label, a.valuesCount, a.callback, a.context);
+        if (i < result.size())
+            result[i] = item;
+    }
+    return *this;
+}
+
+const UFZ::VariableItemList& UFZ::VariableItemList::clearAndRepopulate(const std::span<const Item> items, const uint8_t selected, const std::span<VariableItem*> result) noexcept
+{
+    reset();
+    addItems(items, result);
+    if (selected < items.size())
+        setSelectedItem(selected);
+    return *this;
+}
+
 void UFZ::VariableItemList::setEnterCallback(const VariableItemListEnterCallback callback, void* context) const noexcept
 {
     variable_item_list_set_enter_callback(variable_item_list, callback, context);
@@ -599,4 +680,1196 @@ const UFZ::Widget& UFZ::Widget::addFrameElement(const uint8_t x, const uint8_t y
 {
     widget_add_frame_element(widget, x, y, width, height, radius);
     return *this;
-}
\ No newline at end of file
+}
+// =====================================================================================================================
+// ==================================================== Virtual List ===================================================
+// =====================================================================================================================
+
+static constexpr uint8_t virtualListItemHeight = 12;
+
+UFZ::VirtualList& UFZ::VirtualList::setLabelCallback(const VirtualListLabelCallback callback, void* context) noexcept
+{
+    labelCallback = callback;
+    labelContext = context;
+    return *this;
+}
+
+UFZ::VirtualList& UFZ::VirtualList::setItemCallback(const VirtualListItemCallback callback, void* context) noexcept
+{
+    itemCallback = callback;
+    itemContext = context;
+    return *this;
+}
+
+const UFZ::VirtualList& UFZ::VirtualList::setItemCount(const uint32_t count) const noexcept
+{
+    auto* model = static_cast<Model*>(view.getModel());
+    model->count = count;
+    model->windowStart = 0;
+    select(*model, model->selected < count ? model->selected : 0);
+    fetch(*model, 0, visibleRows(*model));
+    UNUSED(view.commitModel(true));
+    return *this;
+}
+
+const UFZ::VirtualList& UFZ::VirtualList::setHeader(const char* header) const noexcept
+{
+    auto* model = static_cast<Model*>(view.getModel());
+    if (header == nullptr)
+        model->header[0] = '\0';
+    else
+        snprintf(model->header, headerSize, "%s", header);
+
+    // The header takes away a row, so the selection may have to scroll back into view
+    const uint32_t selected = model->selected;
+    model->windowStart = 0;
+    select(*model, selected);
+    fetch(*model, 0, visibleRows(*model));
+    UNUSED(view.commitModel(true));
+    return *this;
+}
+
+const UFZ::VirtualList& UFZ::VirtualList::setSelectedItem(const uint32_t index) const noexcept
+{
+    auto* model = static_cast<Model*>(view.getModel());
+    if (index < model->count)
+        select(*model, index);
+    UNUSED(view.commitModel(true));
+    return *this;
+}
+
+uint32_t UFZ::VirtualList::getSelectedItem() const noexcept
+{
+    const auto* model = static_cast<Model*>(view.getModel());
+    const uint32_t selected = model->selected;
+    UNUSED(view.commitModel(false));
+    return selected;
+}
+
+void UFZ::VirtualList::refresh() const noexcept
+{
+    auto* model = static_cast<Model*>(view.getModel());
+    fetch(*model, 0, visibleRows(*model));
+    UNUSED(view.commitModel(true));
+}
+
+size_t UFZ::VirtualList::visibleRows(const Model& model) noexcept
+{
+    return model.header[0] == '\0' ? maxVisibleRows : maxVisibleRows - 1;
+}
+
+void UFZ::VirtualList::fetch(Model& model, const size_t firstRow, const size_t lastRow) const noexcept
+{
+    for (size_t i = firstRow; i < lastRow; i++)
+    {
+        char* label = model.labels[i];
+        label[0] = '\0';
+        if (labelCallback != nullptr && model.windowStart + i < model.count)
+            labelCallback(labelContext, model.windowStart + i, label, labelSize);
+        label[labelSize - 1] = '\0';
+    }
+}
+
+// Moves the selection and scrolls the window so that it stays visible. Rows that are still on screen after the scroll
+// are shifted in place, only the ones that scrolled in are fetched from the label callback.
+void UFZ::VirtualList::select(Model& model, const uint32_t index) const noexcept
+{
+    const size_t rows = visibleRows(model);
+    const uint32_t oldStart = model.windowStart;
+
+    model.selected = index;
+    if (index < model.windowStart)
+        model.windowStart = index;
+    else if (index >= model.windowStart + rows)
+        model.windowStart = index - rows + 1;
+
+    if (model.windowStart == oldStart)
+        return;
+
+    if (model.windowStart > oldStart && model.windowStart - oldStart < rows)
+    {
+        const size_t shift = model.windowStart - oldStart;
+        memmove(model.labels[0], model.labels[shift], (rows - shift) * labelSize);
+        fetch(model, rows - shift, rows);
+    }
+    else if (model.windowStart < oldStart && oldStart - model.windowStart < rows)
+    {
+        const size_t shift = oldStart - model.windowStart;
+        memmove(model.labels[shift], model.labels[0], (rows - shift) * labelSize);
+        fetch(model, 0, shift);
+    }
+    else
+        fetch(model, 0, rows);
+}
+
+void UFZ::VirtualList::alloc() noexcept
+{
+    view.allocate();
+    UNUSED(view.allocateModel(ViewModelTypeLocking, sizeof(Model)));
+    UNUSED(view.setContext(this));
+
+    UNUSED(view.setDrawCallback([](::Canvas* canvas, void* m) -> void
+    {
+        const auto* model = static_cast<const Model*>(m);
+        const size_t rows = visibleRows(*model);
+        uint8_t y = 0;
+
+        canvas_clear(canvas);
+        if (model->header[0] != '\0')
+        {
+            canvas_set_font(canvas, FontPrimary);
+            canvas_draw_str(canvas, 2, virtualListItemHeight - 2, model->header);
+            y = virtualListItemHeight;
+        }
+
+        canvas_set_font(canvas, FontSecondary);
+        for (size_t i = 0; i < rows && model->windowStart + i < model->count; i++)
+        {
+            if (model->windowStart + i == model->selected)
+            {
+                canvas_set_color(canvas, ColorBlack);
+                canvas_draw_box(canvas, 0, y, 123, virtualListItemHeight);
+                canvas_set_color(canvas, ColorWhite);
+            }
+            canvas_draw_str(canvas, 4, y + virtualListItemHeight - 3, model->labels[i]);
+            canvas_set_color(canvas, ColorBlack);
+            y += virtualListItemHeight;
+        }
+
+        const uint8_t top = model->header[0] == '\0' ? 0 : virtualListItemHeight;
+        elements_scrollbar_pos(canvas, 128, top, 64 - top, model->selected, model->count);
+    }));
+
+    UNUSED(view.setInputCallback([](InputEvent* event, void* context) -> bool
+    {
+        furi_assert(context);
+        const auto* self = static_cast<VirtualList*>(context);
+        if (event->type != InputTypeShort && event->type != InputTypeRepeat)
+            return false;
+
+        auto* model = static_cast<Model*>(self->view.getModel());
+        const uint32_t count = model->count;
+        const uint32_t selected = model->selected;
+        const uint32_t page = static_cast<uint32_t>(visibleRows(*model));
+        bool bConsumed = count > 0;
+
+        if (count > 0)
+        {
+            switch (event->key)
+            {
+            case InputKeyUp:
+                self->select(*model, selected == 0 ? count - 1 : selected - 1);
+                break;
+            case InputKeyDown:
+                self->select(*model, selected + 1 >= count ? 0 : selected + 1);
+                break;
+            case InputKeyLeft:
+                self->select(*model, selected > page ? selected - page : 0);
+                break;
+            case InputKeyRight:
+                self->select(*model, selected + page < count ? selected + page : count - 1);
+                break;
+            case InputKeyOk:
+                break;
+            default:
+                bConsumed = false;
+                break;
+            }
+        }
+        UNUSED(self->view.commitModel(true));
+
+        // Called after the model is released so the callback may safely use the list again
+        if (bConsumed && event->key == InputKeyOk && event->type == InputTypeShort && self->itemCallback != nullptr)
+            self->itemCallback(self->itemContext, selected);
+        return bConsumed;
+    }));
+
+    reset();
+}
+
+void UFZ::VirtualList::free() noexcept
+{
+    view.free();
+}
+
+UFZ::View UFZ::VirtualList::getWidgetView() noexcept
+{
+    return UFZ::View(static_cast<::View*>(view));
+}
+
+void UFZ::VirtualList::reset() noexcept
+{
+    auto* model = static_cast<Model*>(view.getModel());
+    memset(model, 0, sizeof(Model));
+    UNUSED(view.commitModel(true));
+}
+
+// =====================================================================================================================
+// ====================================================== Canvas =======================================================
+// =====================================================================================================================
+
+UFZ::Canvas::Canvas(::Canvas* c, const int32_t x, const int32_t y) noexcept
+{
+    canvas = c;
+    originX = x;
+    originY = y;
+}
+
+UFZ::Canvas::operator ::Canvas*() const noexcept
+{
+    return canvas;
+}
+
+UFZ::Canvas UFZ::Canvas::offset(const int32_t x, const int32_t y) const noexcept
+{
+    return Canvas(canvas, originX + x, originY + y);
+}
+
+size_t UFZ::Canvas::getWidth() const noexcept
+{
+    return canvas_width(canvas);
+}
+
+size_t UFZ::Canvas::getHeight() const noexcept
+{
+    return canvas_height(canvas);
+}
+
+uint16_t UFZ::Canvas::getStringWidth(const char* text) const noexcept
+{
+    return canvas_string_width(canvas, text);
+}
+
+const UFZ::Canvas& UFZ::Canvas::clear() const noexcept
+{
+    canvas_clear(canvas);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::setColor(const Color color) const noexcept
+{
+    canvas_set_color(canvas, color);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::invertColor() const noexcept
+{
+    canvas_invert_color(canvas);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::setFont(const Font font) const noexcept
+{
+    canvas_set_font(canvas, font);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::drawStr(const int32_t x, const int32_t y, const char* text) const noexcept
+{
+    canvas_draw_str(canvas, originX + x, originY + y, text);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::drawStrAligned(const int32_t x, const int32_t y, const Align horizontal, const Align vertical, const char* text) const noexcept
+{
+    canvas_draw_str_aligned(canvas, originX + x, originY + y, horizontal, vertical, text);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::drawStrf(const int32_t x, const int32_t y, const char* format, ...) const noexcept
+{
+    char buffer[formatBufferSize];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return drawStr(x, y, buffer);
+}
+
+const UFZ::Canvas& UFZ::Canvas::drawBox(const int32_t x, const int32_t y, const size_t width, const size_t height) const noexcept
+{
+    canvas_draw_box(canvas, originX + x, originY + y, width, height);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::drawFrame(const int32_t x, const int32_t y, const size_t width, const size_t height) const noexcept
+{
+    canvas_draw_frame(canvas, originX + x, originY + y, width, height);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::drawRBox(const int32_t x, const int32_t y, const size_t width, const size_t height, const size_t radius) const noexcept
+{
+    canvas_draw_rbox(canvas, originX + x, originY + y, width, height, radius);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::drawRFrame(const int32_t x, const int32_t y, const size_t width, const size_t height, const size_t radius) const noexcept
+{
+    canvas_draw_rframe(canvas, originX + x, originY + y, width, height, radius);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::drawLine(const int32_t x1, const int32_t y1, const int32_t x2, const int32_t y2) const noexcept
+{
+    canvas_draw_line(canvas, originX + x1, originY + y1, originX + x2, originY + y2);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::drawDot(const int32_t x, const int32_t y) const noexcept
+{
+    canvas_draw_dot(canvas, originX + x, originY + y);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::drawIcon(const int32_t x, const int32_t y, const Icon* icon) const noexcept
+{
+    canvas_draw_icon(canvas, originX + x, originY + y, icon);
+    return *this;
+}
+
+const UFZ::Canvas& UFZ::Canvas::drawXbm(const int32_t x, const int32_t y, const size_t width, const size_t height, const uint8_t* bitmap) const noexcept
+{
+    canvas_draw_xbm(canvas, originX + x, originY + y, width, height, bitmap);
+    return *this;
+}
+
+// =====================================================================================================================
+// ===================================================== Icon cache ====================================================
+// =====================================================================================================================
+
+static size_t iconFrameBytes(const Icon* icon) noexcept
+{
+    return ((icon->width + 7) / 8) * icon->height;
+}
+
+void UFZ::IconCache::init(const size_t bytes) noexcept
+{
+    budget = bytes;
+    mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    decoder = compress_icon_alloc(maxFrameBytes);
+}
+
+void UFZ::IconCache::free() noexcept
+{
+    for (auto& a : pinned)
+    {
+        FREE_GUARD(::free, a.icon);
+        FREE_GUARD(::free, a.frames);
+    }
+    pinned.clear();
+
+    for (const auto& a : entries)
+        ::free(a.data);
+    entries.clear();
+    entries.shrink_to_fit();
+    used = 0;
+
+    FREE_GUARD(compress_icon_free, decoder);
+    FREE_GUARD(furi_mutex_free, mutex);
+}
+
+UFZ::IconCache::Entry* UFZ::IconCache::lookup(const Icon* icon, const uint32_t frame) noexcept
+{
+    const uint8_t* source = icon->frames[frame];
+    for (auto& a : entries)
+    {
+        if (a.source == source)
+        {
+            hits++;
+            a.lastUse = ++clock;
+            return &a;
+        }
+    }
+    misses++;
+
+    const size_t bytes = iconFrameBytes(icon);
+    if (bytes > maxFrameBytes || !reserve(bytes + 1))
+        return nullptr;
+
+    auto* data = static_cast<uint8_t*>(malloc(bytes + 1));
+    if (data == nullptr)
+        return nullptr;
+
+    uint8_t* decoded = nullptr;
+    compress_icon_decode(decoder, source, &decoded);
+    data[0] = 0;
+    memcpy(data + 1, decoded, bytes);
+
+    used += bytes + 1;
+    entries.push_back({ source, data, bytes + 1, ++clock, 0 });
+    return &entries.back();
+}
+
+// Evicts least recently used frames that are not pinned until bytes more fit in the budget
+bool UFZ::IconCache::reserve(const size_t bytes) noexcept
+{
+    while (used + bytes > budget)
+    {
+        Entry* oldest = nullptr;
+        for (auto& a : entries)
+            if (a.pins == 0 && (oldest == nullptr || a.lastUse < oldest->lastUse))
+                oldest = &a;
+        if (oldest == nullptr)
+            return false;
+
+        used -= oldest->bytes;
+        ::free(oldest->data);
+        *oldest = entries.back();
+        entries.pop_back();
+    }
+    return true;
+}
+
+void UFZ::IconCache::draw(const Canvas& canvas, const int32_t x, const int32_t y, const Icon* icon, uint32_t frame) noexcept
+{
+    if (frame >= icon->frame_count)
+        frame = 0;
+
+    const uint8_t* source = icon->frames[frame];
+    if (source[0] == 0)
+    {
+        UNUSED(canvas.drawXbm(x, y, icon->width, icon->height, source + 1));
+        return;
+    }
+
+    furi_check(furi_mutex_acquire(mutex, FuriWaitForever) == FuriStatusOk);
+    const Entry* entry = lookup(icon, frame);
+    if (entry != nullptr)
+        UNUSED(canvas.drawXbm(x, y, icon->width, icon->height, entry->data + 1));
+    else
+        UNUSED(canvas.drawIcon(x, y, icon));
+    furi_mutex_release(mutex);
+}
+
+const Icon* UFZ::IconCache::acquire(const Icon* icon) noexcept
+{
+    bool bCompressed = false;
+    for (size_t i = 0; i < icon->frame_count; i++)
+        bCompressed |= icon->frames[i][0] != 0;
+    if (!bCompressed)
+        return icon;
+
+    furi_check(furi_mutex_acquire(mutex, FuriWaitForever) == FuriStatusOk);
+    for (auto& a : pinned)
+    {
+        if (a.source == icon)
+        {
+            a.references++;
+            furi_mutex_release(mutex);
+            return a.icon;
+        }
+    }
+
+    auto** frames = static_cast<const uint8_t**>(malloc(icon->frame_count * sizeof(const uint8_t*)));
+    if (frames == nullptr)
+    {
+        furi_mutex_release(mutex);
+        return icon;
+    }
+
+    size_t decoded = 0;
+    for (; decoded < icon->frame_count; decoded++)
+    {
+        Entry* entry = lookup(icon, decoded);
+        if (entry == nullptr)
+            break;
+        entry->pins++;
+        frames[decoded] = entry->data;
+    }
+
+    // Icon's fields are const, so the copy is constructed in place
+    void* memory = decoded == icon->frame_count ? malloc(sizeof(Icon)) : nullptr;
+    const Icon* result = icon;
+    if (memory != nullptr)
+    {
+        auto* copy = new (memory) Icon{ icon->width, icon->height, icon->frame_count, icon->frame_rate, frames };
+        pinned.push_back({ icon, copy, frames, 1 });
+        result = copy;
+    }
+    else
+    {
+        // Not everything fit, unpin what did and fall back to the compressed icon
+        for (size_t i = 0; i < decoded; i++)
+            for (auto& a : entries)
+                if (a.data == frames[i])
+                    a.pins--;
+        FREE_GUARD(::free, frames);
+    }
+    furi_mutex_release(mutex);
+    return result;
+}
+
+void UFZ::IconCache::release(const Icon* decoded) noexcept
+{
+    furi_check(furi_mutex_acquire(mutex, FuriWaitForever) == FuriStatusOk);
+    for (size_t i = 0; i < pinned.size(); i++)
+    {
+        Pinned& pin = pinned[i];
+        if (pin.icon != decoded || --pin.references > 0)
+            continue;
+
+        for (size_t j = 0; j < pin.icon->frame_count; j++)
+            for (auto& a : entries)
+                if (a.data == pin.frames[j])
+                    a.pins--;
+        FREE_GUARD(::free, pin.icon);
+        FREE_GUARD(::free, pin.frames);
+        pinned[i] = pinned.back();
+        pinned.pop_back();
+        break;
+    }
+    furi_mutex_release(mutex);
+}
+
+void UFZ::IconCache::clear() noexcept
+{
+    furi_check(furi_mutex_acquire(mutex, FuriWaitForever) == FuriStatusOk);
+    for (size_t i = 0; i < entries.size();)
+    {
+        if (entries[i].pins > 0)
+        {
+            i++;
+            continue;
+        }
+        used -= entries[i].bytes;
+        ::free(entries[i].data);
+        entries[i] = entries.back();
+        entries.pop_back();
+    }
+    furi_mutex_release(mutex);
+}
+
+size_t UFZ::IconCache::getUsed() const noexcept
+{
+    return used;
+}
+
+size_t UFZ::IconCache::getHits() const noexcept
+{
+    return hits;
+}
+
+size_t UFZ::IconCache::getMisses() const noexcept
+{
+    return misses;
+}
+
+UFZ::IconCache::~IconCache() noexcept
+{
+    free();
+}
+
+// =====================================================================================================================
+// ===================================================== Icon atlas ====================================================
+// =====================================================================================================================
+
+bool UFZ::IconAtlas::load(const Filesystem& filesystem, const char* path) noexcept
+{
+    free();
+    const File file(filesystem, path, FSAM_READ, FSOM_OPEN_EXISTING);
+    if (!file.isOpen())
+        return false;
+
+    data.resize(file.size());
+    if (data.size() < sizeof(Header) || file.read(data.data(), data.size()) != data.size())
+    {
+        free();
+        return false;
+    }
+
+    Header header{};
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != magic || header.version != version || data.size() < sizeof(Header) + header.iconCount * sizeof(Record))
+    {
+        free();
+        return false;
+    }
+
+    // Frame pointer arrays are carved out of one vector, so size it first to keep the pointers stable
+    size_t frameCount = 0;
+    for (size_t i = 0; i < header.iconCount; i++)
+    {
+        Record record{};
+        memcpy(&record, data.data() + sizeof(Header) + i * sizeof(Record), sizeof(record));
+        frameCount += record.frameCount;
+    }
+    frames.reserve(frameCount);
+    icons.reserve(header.iconCount);
+
+    for (size_t i = 0; i < header.iconCount; i++)
+    {
+        Record record{};
+        memcpy(&record, data.data() + sizeof(Header) + i * sizeof(Record), sizeof(record));
+
+        const size_t stride = ((record.width + 7) / 8) * record.height + 1;
+        if (record.frameCount == 0 || record.offset + static_cast<uint64_t>(stride) * record.frameCount > data.size())
+        {
+            free();
+            return false;
+        }
+
+        const size_t first = frames.size();
+        for (size_t j = 0; j < record.frameCount; j++)
+            frames.push_back(data.data() + record.offset + j * stride);
+        icons.push_back(Icon{ record.width, record.height, record.frameCount, record.frameRate, frames.data() + first });
+    }
+    return true;
+}
+
+void UFZ::IconAtlas::free() noexcept
+{
+    icons.clear();
+    icons.shrink_to_fit();
+    frames.clear();
+    frames.shrink_to_fit();
+    data.clear();
+    data.shrink_to_fit();
+}
+
+const Icon* UFZ::IconAtlas::get(const char* name) const noexcept
+{
+    for (size_t i = 0; i < icons.size(); i++)
+    {
+        // A name that fills the field has no terminator, so a longer name must not match it as a prefix
+        const char* record = reinterpret_cast<const char*>(data.data() + sizeof(Header) + i * sizeof(Record));
+        const size_t length = strnlen(record, nameSize);
+        if (strncmp(record, name, length) == 0 && name[length] == '\0')
+            return &icons[i];
+    }
+    return nullptr;
+}
+
+const Icon* UFZ::IconAtlas::get(const size_t index) const noexcept
+{
+    return index < icons.size() ? &icons[index] : nullptr;
+}
+
+size_t UFZ::IconAtlas::size() const noexcept
+{
+    return icons.size();
+}
+
+// =====================================================================================================================
+// ===================================================== Text View =====================================================
+// =====================================================================================================================
+
+static constexpr uint8_t textViewMargin = 2;
+static constexpr uint8_t textViewScrollbarWidth = 4;
+
+const UFZ::TextView& UFZ::TextView::setText(const char* text) const noexcept
+{
+    auto* model = static_cast<Model*>(view.getModel());
+    model->text = text;
+    model->length = text != nullptr ? strlen(text) : 0;
+    model->firstLine = 0;
+    // The same buffer may have been edited in place, so the layout is redone even if the pointer and length match
+    model->generation++;
+    UNUSED(view.commitModel(true));
+    return *this;
+}
+
+const UFZ::TextView& UFZ::TextView::setFont(const Font font) const noexcept
+{
+    auto* model = static_cast<Model*>(view.getModel());
+    model->font = font;
+    UNUSED(view.commitModel(true));
+    return *this;
+}
+
+const UFZ::TextView& UFZ::TextView::setFocus(const TextBoxFocus focus) const noexcept
+{
+    auto* model = static_cast<Model*>(view.getModel());
+    // Clamped to the last page on the next draw
+    model->firstLine = focus == TextBoxFocusEnd ? UINT32_MAX : 0;
+    UNUSED(view.commitModel(true));
+    return *this;
+}
+
+uint32_t UFZ::TextView::getFirstVisibleLine() const noexcept
+{
+    const auto* model = static_cast<Model*>(view.getModel());
+    const uint32_t line = model->firstLine;
+    UNUSED(view.commitModel(false));
+    return line;
+}
+
+// Clamped against the line count on the next draw, once the layout is known
+const UFZ::TextView& UFZ::TextView::setFirstVisibleLine(const uint32_t line) const noexcept
+{
+    auto* model = static_cast<Model*>(view.getModel());
+    model->firstLine = line;
+    UNUSED(view.commitModel(true));
+    return *this;
+}
+
+// Greedy word wrap using the font's real glyph widths. Only runs after setText or when the font or the available width
+// differ from the cached layout; glyph widths need a canvas, hence this runs from the draw callback.
+void UFZ::TextView::layout(::Canvas* canvas, Model& model) noexcept
+{
+    canvas_set_font(canvas, model.font);
+    const size_t width = canvas_width(canvas) - textViewScrollbarWidth - textViewMargin * 2;
+
+    if (model.generation != layoutGeneration || model.font != layoutFont || width != layoutWidth)
+    {
+        layoutGeneration = model.generation;
+        layoutFont = model.font;
+        layoutWidth = width;
+
+        lines.clear();
+        if (model.text != nullptr)
+        {
+            const char* text = model.text;
+            size_t start = 0;
+            size_t lastSpace = SIZE_MAX;
+            size_t lineWidth = 0;
+
+            lines.push_back(0);
+            for (size_t i = 0; i < model.length; i++)
+            {
+                if (text[i] == '\n')
+                {
+                    start = i + 1;
+                    lastSpace = SIZE_MAX;
+                    lineWidth = 0;
+                    lines.push_back(static_cast<uint32_t>(start));
+                    continue;
+                }
+
+                const size_t glyph = canvas_glyph_width(canvas, static_cast<uint8_t>(text[i]));
+                if (lineWidth + glyph > width && i > start)
+                {
+                    // Break after the last space on the line, or mid-word if there is none
+                    if (lastSpace != SIZE_MAX)
+                        start = lastSpace + 1;
+                    else
+                        start = i;
+                    lines.push_back(static_cast<uint32_t>(start));
+
+                    lastSpace = SIZE_MAX;
+                    lineWidth = 0;
+                    for (size_t j = start; j < i; j++)
+                        lineWidth += canvas_glyph_width(canvas, static_cast<uint8_t>(text[j]));
+                }
+
+                if (text[i] == ' ')
+                    lastSpace = i;
+                lineWidth += glyph;
+            }
+        }
+        lines.shrink_to_fit();
+
+        lineHeight = static_cast<uint8_t>(canvas_current_font_height(canvas) + 1);
+        visibleLines = static_cast<uint8_t>(canvas_height(canvas) / lineHeight);
+        if (visibleLines == 0)
+            visibleLines = 1;
+    }
+
+    const uint32_t lastFirstLine = lines.size() > visibleLines ? static_cast<uint32_t>(lines.size() - visibleLines) : 0;
+    if (model.firstLine > lastFirstLine)
+        model.firstLine = lastFirstLine;
+}
+
+void UFZ::TextView::alloc() noexcept
+{
+    view.allocate();
+    UNUSED(view.allocateModel(ViewModelTypeLocking, sizeof(Model)));
+    UNUSED(view.setContext(this));
+
+    UNUSED(view.setDrawCallback([](::Canvas* canvas, void* m) -> void
+    {
+        auto* model = static_cast<Model*>(m);
+        auto* self = model->self;
+
+        canvas_clear(canvas);
+        self->layout(canvas, *model);
+        if (self->lines.empty())
+            return;
+
+        char line[128];
+        uint8_t y = self->lineHeight - 1;
+        for (size_t i = model->firstLine; i < self->lines.size() && i < model->firstLine + self->visibleLines; i++)
+        {
+            size_t end = i + 1 < self->lines.size() ? self->lines[i + 1] : model->length;
+            size_t length = end - self->lines[i];
+
+            // Drop the newline or the space the line was broken at
+            while (length > 0 && (model->text[self->lines[i] + length - 1] == '\n' || model->text[self->lines[i] + length - 1] == ' '))
+                length--;
+            if (length >= sizeof(line))
+                length = sizeof(line) - 1;
+
+            memcpy(line, model->text + self->lines[i], length);
+            line[length] = '\0';
+            canvas_draw_str(canvas, textViewMargin, y, line);
+            y += self->lineHeight;
+        }
+
+        if (self->lines.size() > self->visibleLines)
+            elements_scrollbar_pos(canvas, canvas_width(canvas), 0, canvas_height(canvas), model->firstLine, self->lines.size() - self->visibleLines + 1);
+    }));
+
+    UNUSED(view.setInputCallback([](InputEvent* event, void* context) -> bool
+    {
+        furi_assert(context);
+        const auto* self = static_cast<TextView*>(context);
+        if (event->type != InputTypeShort && event->type != InputTypeRepeat)
+            return false;
+        if (event->key != InputKeyUp && event->key != InputKeyDown && event->key != InputKeyLeft && event->key != InputKeyRight)
+            return false;
+
+        // Scrolling past the end is clamped by the next layout pass
+        auto* model = static_cast<Model*>(self->view.getModel());
+        const uint32_t page = self->visibleLines;
+        switch (event->key)
+        {
+        case InputKeyUp:
+            model->firstLine = model->firstLine > 0 ? model->firstLine - 1 : 0;
+            break;
+        case InputKeyDown:
+            model->firstLine++;
+            break;
+        case InputKeyLeft:
+            model->firstLine = model->firstLine > page ? model->firstLine - page : 0;
+            break;
+        default:
+            model->firstLine += page;
+            break;
+        }
+        UNUSED(self->view.commitModel(true));
+        return true;
+    }));
+
+    reset();
+}
+
+void UFZ::TextView::free() noexcept
+{
+    view.free();
+    lines.clear();
+    lines.shrink_to_fit();
+    layoutGeneration = 0;
+}
+
+UFZ::View UFZ::TextView::getWidgetView() noexcept
+{
+    return UFZ::View(static_cast<::View*>(view));
+}
+
+void UFZ::TextView::reset() noexcept
+{
+    auto* model = static_cast<Model*>(view.getModel());
+    model->self = this;
+    model->text = nullptr;
+    model->length = 0;
+    model->generation = layoutGeneration + 1;
+    model->firstLine = 0;
+    model->font = FontSecondary;
+    UNUSED(view.commitModel(true));
+}
+
+// =====================================================================================================================
+// ===================================================== File View =====================================================
+// =====================================================================================================================
+
+static constexpr uint8_t fileViewLineHeight = 10;
+static constexpr size_t fileViewChunkSize = 256;
+
+bool UFZ::FileView::open(const Filesystem& filesystem, const char* path, const char* indexPath) noexcept
+{
+    close();
+    if (!ownedFile.open(filesystem, path, FSAM_READ, FSOM_OPEN_EXISTING))
+    {
+        ownedFile.close();
+        return false;
+    }
+    file = &ownedFile;
+    if (indexPath != nullptr ? !lines.open(filesystem, path, ownedFile, indexPath) : !lines.build(ownedFile))
+    {
+        close();
+        return false;
+    }
+    index();
+    return true;
+}
+
+bool UFZ::FileView::open(File& source) noexcept
+{
+    close();
+    if (!source.isOpen())
+        return false;
+    file = &source;
+    if (!lines.build(source))
+    {
+        close();
+        return false;
+    }
+    index();
+    return true;
+}
+
+void UFZ::FileView::close() noexcept
+{
+    ownedFile.close();
+    file = nullptr;
+    lines.clear();
+
+    if (view != nullptr)
+        reset();
+}
+
+// Shows the freshly indexed file from the top
+void UFZ::FileView::index() noexcept
+{
+    const auto* model = static_cast<Model*>(view.getModel());
+    const bool bHex = model->bHex;
+    UNUSED(view.commitModel(false));
+
+    show(0, bHex, bHex ? static_cast<uint32_t>((lines.getSourceSize() + hexBytesPerRow - 1) / hexBytesPerRow) : lines.getLineCount());
+}
+
+// Reads the rows starting at firstLine into staging, seeking to the closest indexed line before them
+void UFZ::FileView::load(const uint32_t firstLine, const bool bHex) const noexcept
+{
+    for (auto& a : staging)
+        a[0] = '\0';
+    if (file == nullptr)
+        return;
+
+    if (bHex)
+    {
+        uint8_t bytes[hexBytesPerRow * visibleRows];
+        const uint32_t start = firstLine * hexBytesPerRow;
+        if (!file->seek(start, true))
+            return;
+
+        const size_t read = file->read(bytes, sizeof(bytes));
+        for (size_t row = 0; row < visibleRows && row * hexBytesPerRow < read; row++)
+        {
+            char* out = staging[row];
+            int length = snprintf(out, maxLineLength + 1, "%06lX:", static_cast<unsigned long>(start + row * hexBytesPerRow));
+            for (size_t i = 0; i < hexBytesPerRow; i++)
+            {
+                const size_t j = row * hexBytesPerRow + i;
+                length += j < read ? snprintf(out + length, maxLineLength + 1 - length, " %02X", bytes[j]) : snprintf(out + length, maxLineLength + 1 - length, "   ");
+            }
+            out[length++] = ' ';
+            for (size_t i = 0; i < hexBytesPerRow && row * hexBytesPerRow + i < read; i++)
+            {
+                const char c = static_cast<char>(bytes[row * hexBytesPerRow + i]);
+                out[length++] = c >= 0x20 && c < 0x7F ? c : '.';
+            }
+            out[length] = '\0';
+        }
+        return;
+    }
+
+    uint32_t line = lines.seek(*file, firstLine);
+    if (line == UINT32_MAX)
+        return;
+
+    char chunk[fileViewChunkSize];
+    LineIndex::Splitter splitter;
+    size_t row = 0;
+    size_t bytes;
+
+    while (row < visibleRows && (bytes = file->read(chunk, sizeof(chunk))) > 0)
+    {
+        for (size_t i = 0; i < bytes && row < visibleRows; i++)
+        {
+            const size_t column = splitter.length;
+            const bool bEnd = splitter.feed(chunk[i]);
+
+            if (line >= firstLine && chunk[i] != '\n')
+            {
+                staging[row][column] = chunk[i] == '\t' || chunk[i] == '\r' ? ' ' : chunk[i];
+                staging[row][column + 1] = '\0';
+            }
+
+            if (bEnd)
+            {
+                if (line >= firstLine)
+                    row++;
+                line++;
+                if (row < visibleRows)
+                    staging[row][0] = '\0';
+            }
+        }
+    }
+}
+
+// The model is locked only to copy the freshly read rows in, the card is read before that
+void UFZ::FileView::show(const uint32_t firstLine, const bool bHex, const uint32_t lineCount) const noexcept
+{
+    load(firstLine, bHex);
+
+    auto* model = static_cast<Model*>(view.getModel());
+    memcpy(model->rows, staging, sizeof(Rows));
+    model->firstLine = firstLine;
+    model->lineCount = lineCount;
+    if (model->bHex != bHex)
+        model->column = 0;
+    model->bHex = bHex;
+    UNUSED(view.commitModel(true));
+}
+
+void UFZ::FileView::scroll(const uint32_t line, const bool bForce) const noexcept
+{
+    const auto* model = static_cast<Model*>(view.getModel());
+    const uint32_t firstLine = model->firstLine;
+    const uint32_t lineCount = model->lineCount;
+    const bool bHex = model->bHex;
+    UNUSED(view.commitModel(false));
+
+    const uint32_t last = lineCount > visibleRows ? lineCount - static_cast<uint32_t>(visibleRows) : 0;
+    const uint32_t target = line > last ? last : line;
+    if (target != firstLine || bForce)
+        show(target, bHex, lineCount);
+}
+
+// Right only moves while a row on screen still goes past the new column, so the text never scrolls out of view
+void UFZ::FileView::shift(const bool bRight) const noexcept
+{
+    auto* model = static_cast<Model*>(view.getModel());
+    bool bChanged = false;
+    if (!bRight)
+    {
+        bChanged = model->column > 0;
+        model->column = model->column > horizontalStep ? static_cast<uint8_t>(model->column - horizontalStep) : 0;
+    }
+    else
+    {
+        for (const auto& a : model->rows)
+        {
+            if (strnlen(a, sizeof(a)) > model->column + horizontalStep)
+            {
+                model->column += horizontalStep;
+                bChanged = true;
+                break;
+            }
+        }
+    }
+    UNUSED(view.commitModel(bChanged));
+}
+
+const UFZ::FileView& UFZ::FileView::setHexMode(const bool bHex) const noexcept
+{
+    const auto* model = static_cast<Model*>(view.getModel());
+    const uint32_t firstLine = model->firstLine;
+    const bool bWasHex = model->bHex;
+    UNUSED(view.commitModel(false));
+
+    if (bWasHex != bHex)
+    {
+        // Keep roughly the same spot in the file when switching between line and byte based rows
+        uint32_t line;
+        if (bHex)
+            line = static_cast<uint32_t>((file != nullptr && lines.seek(*file, firstLine) != UINT32_MAX ? file->tell() : 0) / hexBytesPerRow);
+        else
+            line = lines.lineAt(static_cast<uint64_t>(firstLine) * hexBytesPerRow);
+
+        const uint32_t lineCount = bHex ? static_cast<uint32_t>((lines.getSourceSize() + hexBytesPerRow - 1) / hexBytesPerRow) : lines.getLineCount();
+        const uint32_t last = lineCount > visibleRows ? lineCount - static_cast<uint32_t>(visibleRows) : 0;
+        show(line > last ? last : line, bHex, lineCount);
+    }
+    return *this;
+}
+
+uint32_t UFZ::FileView::getLineCount() const noexcept
+{
+    const auto* model = static_cast<Model*>(view.getModel());
+    const uint32_t count = model->lineCount;
+    UNUSED(view.commitModel(false));
+    return count;
+}
+
+const UFZ::FileView& UFZ::FileView::setFirstVisibleLine(const uint32_t line) const noexcept
+{
+    scroll(line);
+    return *this;
+}
+
+void UFZ::FileView::alloc() noexcept
+{
+    view.allocate();
+    UNUSED(view.allocateModel(ViewModelTypeLocking, sizeof(Model)));
+    UNUSED(view.setContext(this));
+
+    UNUSED(view.setDrawCallback([](::Canvas* canvas, void* m) -> void
+    {
+        const auto* model = static_cast<const Model*>(m);
+
+        canvas_clear(canvas);
+        canvas_set_font(canvas, model->bHex ? FontKeyboard : FontSecondary);
+        for (size_t i = 0; i < visibleRows; i++)
+        {
+            const char* row = model->rows[i];
+            const size_t length = strnlen(row, sizeof(model->rows[i]));
+            canvas_draw_str(canvas, 0, static_cast<int32_t>((i + 1) * fileViewLineHeight - 2), model->column < length ? row + model->column : "");
+        }
+
+        if (model->lineCount > visibleRows)
+            elements_scrollbar_pos(canvas, 128, 0, 64, model->firstLine, model->lineCount - visibleRows + 1);
+    }));
+
+    UNUSED(view.setInputCallback([](InputEvent* event, void* context) -> bool
+    {
+        furi_assert(context);
+        const auto* self = static_cast<FileView*>(context);
+        if (event->type != InputTypeShort && event->type != InputTypeLong && event->type != InputTypeRepeat)
+            return false;
+
+        // A short left or right press scrolls sideways, holding it pages. Scrolling reads the card, so the model is
+        // not held across it.
+        const auto* model = static_cast<Model*>(self->view.getModel());
+        const uint32_t line = model->firstLine;
+        UNUSED(self->view.commitModel(false));
+
+        switch (event->key)
+        {
+        case InputKeyUp:
+            self->scroll(line > 0 ? line - 1 : 0);
+            break;
+        case InputKeyDown:
+            self->scroll(line + 1);
+            break;
+        case InputKeyLeft:
+            if (event->type == InputTypeShort)
+                self->shift(false);
+            else
+                self->scroll(line > visibleRows ? line - static_cast<uint32_t>(visibleRows) : 0);
+            break;
+        case InputKeyRight:
+            if (event->type == InputTypeShort)
+                self->shift(true);
+            else
+                self->scroll(line + static_cast<uint32_t>(visibleRows));
+            break;
+        default:
+            return false;
+        }
+        return true;
+    }));
+
+    reset();
+}
+
+void UFZ::FileView::free() noexcept
+{
+    close();
+    view.free();
+}
+
+UFZ::View UFZ::FileView::getWidgetView() noexcept
+{
+    return UFZ::View(static_cast<::View*>(view));
+}
+
+void UFZ::FileView::reset() noexcept
+{
+    auto* model = static_cast<Model*>(view.getModel());
+    memset(model, 0, sizeof(Model));
+    UNUSED(view.commitModel(false));
+
+    show(0, false, file != nullptr ? lines.getLineCount() : 0);
+}
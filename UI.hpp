@@ -3,6 +3,7 @@
 #include "Filesystem.hpp"
 
 #include <functional>
+#include <span>
 #include <vector>
 
 #include <gui/modules/menu.h>
@@ -21,9 +22,11 @@
 #include <gui/modules/widget.h>
 
 #include <gui/view_stack.h>
+#include <gui/elements.h>
 #include <furi.h>
 #include <gui/gui.h>
 #include <gui/icon_i.h>
+#include <toolbox/compress.h>
 #include <gui/view_dispatcher.h>
 
 // Generates a function from a prefix and postfix, for example given (menu, free) will return the function with the name
@@ -92,6 +95,176 @@ namespace UFZ
         ::View* view = nullptr;
     };
 
+    // Thin wrapper over the Canvas given to draw callbacks. Coordinates are relative to an origin, so a part of the
+    // screen can be drawn by code that does not know where that part is placed.
+    class Canvas
+    {
+    public:
+        Canvas() = default;
+        explicit Canvas(::Canvas* c, int32_t originX = 0, int32_t originY = 0) noexcept;
+        operator ::Canvas*() const noexcept;
+
+        // A canvas drawing to the same frame with its origin moved by x, y
+        [[nodiscard]] Canvas offset(int32_t x, int32_t y) const noexcept;
+
+        [[nodiscard]] size_t getWidth() const noexcept;
+        [[nodiscard]] size_t getHeight() const noexcept;
+        [[nodiscard]] uint16_t getStringWidth(const char* text) const noexcept;
+
+        const Canvas& clear() const noexcept;
+        const Canvas& setColor(Color color) const noexcept;
+        const Canvas& invertColor() const noexcept;
+        const Canvas& setFont(Font font) const noexcept;
+
+        const Canvas& drawStr(int32_t x, int32_t y, const char* text) const noexcept;
+        const Canvas& drawStrAligned(int32_t x, int32_t y, Align horizontal, Align vertical, const char* text) const noexcept;
+
+        // Formats into a stack buffer of formatBufferSize bytes, longer output is cut off
+        const Canvas& drawStrf(int32_t x, int32_t y, const char* format, ...) const noexcept __attribute__((format(printf, 4, 5)));
+
+        const Canvas& drawBox(int32_t x, int32_t y, size_t width, size_t height) const noexcept;
+        const Canvas& drawFrame(int32_t x, int32_t y, size_t width, size_t height) const noexcept;
+        const Canvas& drawRBox(int32_t x, int32_t y, size_t width, size_t height, size_t radius) const noexcept;
+        const Canvas& drawRFrame(int32_t x, int32_t y, size_t width, size_t height, size_t radius) const noexcept;
+        const Canvas& drawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2) const noexcept;
+        const Canvas& drawDot(int32_t x, int32_t y) const noexcept;
+        const Canvas& drawIcon(int32_t x, int32_t y, const Icon* icon) const noexcept;
+        const Canvas& drawXbm(int32_t x, int32_t y, size_t width, size_t height, const uint8_t* bitmap) const noexcept;
+
+        static constexpr size_t formatBufferSize = 48;
+    private:
+        ::Canvas* canvas = nullptr;
+        int32_t originX = 0;
+        int32_t originY = 0;
+    };
+
+    // Keeps decoded icon frames in RAM so compressed icons are not decompressed on every draw. Frames are evicted least
+    // recently used first once the decoded bytes would exceed the budget. draw() serves custom draw callbacks;
+    // modules such as ButtonPanel and Widget draw icons themselves, so acquire() hands out a copy of an icon whose
+    // frames are all decoded and stay pinned until release(). Uncompressed frames are used as they are and never
+    // cached. Safe to use from the GUI thread and the application thread at the same time.
+    class IconCache
+    {
+    public:
+        // Largest decoded frame, a full screen
+        static constexpr size_t maxFrameBytes = (128 / 8) * 64;
+
+        IconCache() = default;
+
+        // Owns the decoder and the decoded frames, both freed in free()
+        IconCache(const IconCache&) = delete;
+        IconCache& operator=(const IconCache&) = delete;
+
+        void init(size_t budget) noexcept;
+        void free() noexcept;
+
+        void draw(const Canvas& canvas, int32_t x, int32_t y, const Icon* icon, uint32_t frame = 0) noexcept;
+
+        // Returns icon itself if it is not compressed or its frames do not fit in the budget
+        [[nodiscard]] const Icon* acquire(const Icon* icon) noexcept;
+        void release(const Icon* decoded) noexcept;
+
+        // Drops every frame that is not pinned
+        void clear() noexcept;
+
+        [[nodiscard]] size_t getUsed() const noexcept;
+        [[nodiscard]] size_t getHits() const noexcept;
+        [[nodiscard]] size_t getMisses() const noexcept;
+
+        ~IconCache() noexcept;
+    private:
+        struct Entry
+        {
+            const uint8_t* source;
+
+            // A raw frame: a zero header byte followed by the XBM bitmap, so it can back an Icon as well
+            uint8_t* data;
+            size_t bytes;
+            uint32_t lastUse;
+            uint16_t pins;
+        };
+
+        struct Pinned
+        {
+            const Icon* source;
+            Icon* icon;
+            const uint8_t** frames;
+            size_t references;
+        };
+
+        std::vector<Entry> entries{};
+        std::vector<Pinned> pinned{};
+
+        FuriMutex* mutex = nullptr;
+        CompressIcon* decoder = nullptr;
+
+        size_t budget = 0;
+        size_t used = 0;
+        size_t hits = 0;
+        size_t misses = 0;
+        uint32_t clock = 0;
+
+        // Both expect the mutex to be held
+        Entry* lookup(const Icon* icon, uint32_t frame) noexcept;
+        bool reserve(size_t bytes) noexcept;
+    };
+
+    // Icons loaded from a file at runtime instead of being compiled into the application. The returned icons are
+    // ordinary Icons, so they work anywhere a compiled in one does, and stay valid until free() or the next load().
+    // Build the file with Tools/ufzatlas.py.
+    //
+    // File layout, little endian:
+    //   Header             { uint32 magic "UFZA", uint16 version, uint16 iconCount }
+    //   Record[iconCount]  { char name[16], uint16 width, uint16 height, uint8 frameCount, uint8 frameRate,
+    //                        uint16 reserved, uint32 offset }
+    //   Frames             at each record's offset, frameCount frames of one zero byte followed by
+    //                      ((width + 7) / 8) * height bytes of XBM bitmap
+    class IconAtlas
+    {
+    public:
+        static constexpr size_t nameSize = 16;
+
+        IconAtlas() = default;
+
+        // Icons point into the atlas' own buffers
+        IconAtlas(const IconAtlas&) = delete;
+        IconAtlas& operator=(const IconAtlas&) = delete;
+
+        bool load(const Filesystem& filesystem, const char* path) noexcept;
+        void free() noexcept;
+
+        // Exact match on the whole name, nullptr if no icon has it
+        [[nodiscard]] const Icon* get(const char* name) const noexcept;
+        [[nodiscard]] const Icon* get(size_t index) const noexcept;
+        [[nodiscard]] size_t size() const noexcept;
+    private:
+        struct Header
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t iconCount;
+        };
+
+        struct Record
+        {
+            char name[nameSize];
+            uint16_t width;
+            uint16_t height;
+            uint8_t frameCount;
+            uint8_t frameRate;
+            uint16_t reserved;
+            uint32_t offset;
+        };
+        static_assert(sizeof(Header) == 8 && sizeof(Record) == 28, "The atlas layout is part of the file format");
+
+        static constexpr uint32_t magic = 0x415A4655; // "UFZA"
+        static constexpr uint16_t version = 1;
+
+        std::vector<uint8_t> data{};
+        std::vector<Icon> icons{};
+        std::vector<const uint8_t*> frames{};
+    };
+
     class UWidget
     {
     public:
@@ -145,7 +318,21 @@ namespace UFZ
     {
         UFZ_COMPONENT(Menu, menu);
     public:
+        struct Item
+        {
+            const char* label;
+            const Icon* icon;
+            uint32_t index;
+            MenuItemCallback callback;
+            void* context;
+        };
+
         const Menu& addItem(const char* label, const Icon* icon, uint32_t index, MenuItemCallback callback, void* context) const noexcept;
+        const Menu& addItems(std::span<const Item> items) const noexcept;
+
+        // Resets the menu and fills it with items. The module keeps its item storage across the reset, so rebuilding a
+        // menu of the same size does not reallocate. items[selected] is selected if it exists.
+        const Menu& clearAndRepopulate(std::span<const Item> items, uint32_t selected = 0) noexcept;
         void setSelectedItem(uint32_t index) const noexcept;
     };
 
@@ -153,7 +340,21 @@ namespace UFZ
     {
         UFZ_COMPONENT(ButtonMenu, button_menu);
     public:
+        struct Item
+        {
+            const char* label;
+            int32_t index;
+            ButtonMenuItemCallback callback;
+            ButtonMenuItemType type;
+            void* context;
+        };
+
         ButtonMenuItem* addItem(const char* label, int32_t index, ButtonMenuItemCallback callback, ButtonMenuItemType type, void* context) const noexcept;
+
+        // When result is not empty, the handle of items[i] is written to result[i]. clearAndRepopulate resets the menu
+        // first, reusing the module's item storage, and selects items[selected] if it exists.
+        const ButtonMenu& addItems(std::span<const Item> items, std::span<ButtonMenuItem*> result = {}) const noexcept;
+        const ButtonMenu& clearAndRepopulate(std::span<const Item> items, uint32_t selected = 0, std::span<ButtonMenuItem*> result = {}) noexcept;
         void setHeader(const char* header) const noexcept;
         void setSelectedItem(uint32_t index) const noexcept;
     };
@@ -266,7 +467,20 @@ namespace UFZ
     {
         UFZ_COMPONENT(Submenu, submenu);
     public:
+        struct Item
+        {
+            const char* label;
+            uint32_t index;
+            SubmenuItemCallback callback;
+            void* context;
+        };
+
         const Submenu& addItem(const char* label, uint32_t index, SubmenuItemCallback callback, void* context) const noexcept;
+        const Submenu& addItems(std::span<const Item> items) const noexcept;
+
+        // Resets the submenu and fills it with items, reusing the module's item storage. reset() clears the header, so
+        // pass it again here. items[selected] is selected if it exists.
+        const Submenu& clearAndRepopulate(std::span<const Item> items, uint32_t selected = 0, const char* header = nullptr) noexcept;
         const Submenu& setSelectedItem(uint32_t index) const noexcept;
         const Submenu& setHeader(const char* header) const noexcept;
     };
@@ -294,12 +508,326 @@ namespace UFZ
     {
         UFZ_COMPONENT(VariableItemList, variable_item_list);
     public:
+        struct Item
+        {
+            const char* label;
+            uint8_t valuesCount;
+            VariableItemChangeCallback callback;
+            void* context;
+        };
+
         VariableItem* add(const char* label, uint8_t values_count, VariableItemChangeCallback callback, void* context) const noexcept;
+
+        // When result is not empty, the handle of items[i] is written to result[i]. clearAndRepopulate resets the list
+        // first, reusing the module's item storage, and selects items[selected] if it exists.
+        const VariableItemList& addItems(std::span<const Item> items, std::span<VariableItem*> result = {}) const noexcept;
+        const VariableItemList& clearAndRepopulate(std::span<const Item> items, uint8_t selected = 0, std::span<VariableItem*> result = {}) noexcept;
         void setEnterCallback(VariableItemListEnterCallback callback, void* context) const noexcept;
         void setSelectedItem(uint8_t index) const noexcept;
         [[nodiscard]] uint8_t getSelectedItemIndex() const noexcept;
     };
 
+    // Fills label with the text of item index. label is labelSize bytes long and is always null-terminated by the
+    // caller afterwards, so long labels may simply be truncated.
+    using VirtualListLabelCallback = void(*)(void* context, uint32_t index, char* label, size_t labelSize);
+    using VirtualListItemCallback = void(*)(void* context, uint32_t index);
+
+    // A list that only knows its item count. Labels are requested from the label callback for the rows currently on
+    // screen and are dropped again once they scroll out, so memory use is constant whatever the size of the list. Use
+    // it instead of Submenu when the items come from a Directory stream, a file index or any other large data source.
+    class VirtualList final : public UWidget
+    {
+    public:
+        VirtualList() = default;
+
+        static constexpr size_t maxVisibleRows = 5;
+        static constexpr size_t labelSize = 48;
+        static constexpr size_t headerSize = 32;
+
+        VirtualList& setLabelCallback(VirtualListLabelCallback callback, void* context) noexcept;
+        VirtualList& setItemCallback(VirtualListItemCallback callback, void* context) noexcept;
+
+        const VirtualList& setItemCount(uint32_t count) const noexcept;
+        const VirtualList& setHeader(const char* header) const noexcept;
+        const VirtualList& setSelectedItem(uint32_t index) const noexcept;
+        [[nodiscard]] uint32_t getSelectedItem() const noexcept;
+
+        // Re-fetches the labels on screen, call when the data behind the label callback changes
+        void refresh() const noexcept;
+    private:
+        struct Model
+        {
+            char labels[maxVisibleRows][labelSize];
+            char header[headerSize];
+            uint32_t count;
+            uint32_t selected;
+            uint32_t windowStart;
+        };
+
+        View view{};
+
+        VirtualListLabelCallback labelCallback = nullptr;
+        void* labelContext = nullptr;
+        VirtualListItemCallback itemCallback = nullptr;
+        void* itemContext = nullptr;
+
+        [[nodiscard]] static size_t visibleRows(const Model& model) noexcept;
+        void fetch(Model& model, size_t firstRow, size_t lastRow) const noexcept;
+        void select(Model& model, uint32_t index) const noexcept;
+
+        virtual void alloc() noexcept override;
+        virtual void free() noexcept override;
+        virtual View getWidgetView() noexcept override;
+        virtual void reset() noexcept override;
+    };
+
+    // Scrollable text like TextBox, but line breaks are computed once per text, font and width and then cached as line
+    // offsets. Each frame only draws the lines on screen instead of re-wrapping the whole text, which keeps scrolling
+    // through long logs smooth.
+    class TextView final : public UWidget
+    {
+    public:
+        TextView() = default;
+
+        // The text is not copied and must outlive the view or the next setText call
+        const TextView& setText(const char* text) const noexcept;
+        const TextView& setFont(Font font) const noexcept;
+        const TextView& setFocus(TextBoxFocus focus) const noexcept;
+
+        [[nodiscard]] uint32_t getFirstVisibleLine() const noexcept;
+        const TextView& setFirstVisibleLine(uint32_t line) const noexcept;
+    private:
+        struct Model
+        {
+            TextView* self;
+            const char* text;
+            size_t length;
+
+            // Bumped by every setText, the layout is cached per generation
+            uint32_t generation;
+            uint32_t firstLine;
+            Font font;
+        };
+
+        View view{};
+
+        // Layout cache, only touched with the model locked. lines holds the offset at which each line starts.
+        std::vector<uint32_t> lines{};
+        uint32_t layoutGeneration = 0;
+        size_t layoutWidth = 0;
+        Font layoutFont = FontSecondary;
+        uint8_t lineHeight = 0;
+        uint8_t visibleLines = 1;
+
+        void layout(::Canvas* canvas, Model& model) noexcept;
+
+        virtual void alloc() noexcept override;
+        virtual void free() noexcept override;
+        virtual View getWidgetView() noexcept override;
+        virtual void reset() noexcept override;
+    };
+
+    // Shows a file of any size without loading it. Opening the file builds a LineIndex; scrolling then seeks to the
+    // nearest indexed line and reads just the lines on screen into a small buffer with the model unlocked, so drawing
+    // never waits on the card. Lines longer than maxLineLength bytes are split, which is still wider than the screen:
+    // pressing left or right scrolls the rows sideways by horizontalStep characters and holding them pages up and down.
+    // In hex mode rows are fixed hexBytesPerRow byte slices and no index is needed.
+    class FileView final : public UWidget
+    {
+    public:
+        FileView() = default;
+
+        static constexpr size_t visibleRows = 6;
+        static constexpr size_t maxLineLength = LineIndex::maxLineLength;
+        static constexpr size_t hexBytesPerRow = 4;
+        static constexpr size_t horizontalStep = 8;
+
+        // Opens and indexes path, the file is owned and closed by the view. If indexPath is set the index is kept in
+        // that sidecar file and reused on the next open for as long as path is unchanged.
+        bool open(const Filesystem& filesystem, const char* path, const char* indexPath = nullptr) noexcept;
+
+        // Indexes an already open file, which must stay open until close() or the next open()
+        bool open(File& source) noexcept;
+        void close() noexcept;
+
+        const FileView& setHexMode(bool bHex) const noexcept;
+        [[nodiscard]] uint32_t getLineCount() const noexcept;
+        const FileView& setFirstVisibleLine(uint32_t line) const noexcept;
+    private:
+        using Rows = char[visibleRows][maxLineLength + 1];
+
+        struct Model
+        {
+            Rows rows;
+            uint32_t firstLine;
+            uint32_t lineCount;
+            uint8_t column;
+            bool bHex;
+        };
+
+        View view{};
+
+        File ownedFile{};
+        File* file = nullptr;
+        LineIndex lines{};
+
+        // Rows are read into this on the GUI thread and then copied into the model
+        mutable Rows staging{};
+
+        void index() noexcept;
+        void load(uint32_t firstLine, bool bHex) const noexcept;
+        void show(uint32_t firstLine, bool bHex, uint32_t lineCount) const noexcept;
+        void scroll(uint32_t line, bool bForce = false) const noexcept;
+        void shift(bool bRight) const noexcept;
+
+        virtual void alloc() noexcept override;
+        virtual void free() noexcept override;
+        virtual View getWidgetView() noexcept override;
+        virtual void reset() noexcept override;
+    };
+
+    // A custom view split into regions, each drawn by its own callback from a slice of the model T. Changes go through
+    // update(), which compares every region's slice with its value at the previous update and only asks the GUI for
+    // a redraw if one of them changed, so an always-on screen that keeps getting the same values never wakes the
+    // display. The GUI clears the whole frame before each draw, so a redraw draws every region again; the bDirty
+    // argument tells a region whether its own slice changed since it was last drawn, letting it keep whatever it
+    // derives from the slice (formatted text, layout) instead of rebuilding it.
+    template<typename T>
+    class RegionView final : public UWidget
+    {
+    public:
+        static_assert(std::is_trivially_copyable_v<T>, "Region slices are compared byte by byte");
+
+        static constexpr size_t maxRegions = 32;
+
+        using DrawCallback = void(*)(Canvas& canvas, const T& model, bool bDirty);
+
+        RegionView() = default;
+
+        // Declares a region with its origin at x, y whose callback only reads size bytes of the model starting at
+        // offset, usually offsetof and sizeof of a field. A region with a size of 0 never causes a redraw. Returns
+        // the index of the region, or maxRegions if there is no room left.
+        size_t addRegion(const int32_t x, const int32_t y, const size_t offset, const size_t size, const DrawCallback callback) noexcept
+        {
+            if (regionCount == maxRegions || offset + size > sizeof(T))
+                return maxRegions;
+
+            // Regions are read by the draw callback with the model locked
+            auto* model = static_cast<Model*>(view.getModel());
+            regions[regionCount] = { x, y, offset, size, callback };
+            model->dirty |= 1u << regionCount;
+            UNUSED(view.commitModel(true));
+            return regionCount++;
+        }
+
+        // Calls f with the model locked, then redraws if any region's slice changed
+        template<typename F>
+        void update(F&& f) noexcept
+        {
+            auto* model = static_cast<Model*>(view.getModel());
+            f(model->data);
+
+            uint32_t changed = 0;
+            const auto* current = reinterpret_cast<const uint8_t*>(&model->data);
+            auto* previous = reinterpret_cast<uint8_t*>(&committed);
+            for (size_t i = 0; i < regionCount; i++)
+            {
+                const Region& region = regions[i];
+                if (region.size > 0 && memcmp(current + region.offset, previous + region.offset, region.size) != 0)
+                    changed |= 1u << i;
+            }
+            memcpy(previous, current, sizeof(T));
+
+            if (changed == 0)
+                skippedUpdates++;
+            model->dirty |= changed;
+            UNUSED(view.commitModel(changed != 0));
+        }
+
+        [[nodiscard]] T get() const noexcept
+        {
+            const auto* model = static_cast<Model*>(view.getModel());
+            const T data = model->data;
+            UNUSED(view.commitModel(false));
+            return data;
+        }
+
+        // Number of updates that did not need a redraw
+        [[nodiscard]] size_t getSkippedUpdates() const noexcept
+        {
+            return skippedUpdates;
+        }
+    private:
+        struct Region
+        {
+            int32_t x;
+            int32_t y;
+            size_t offset;
+            size_t size;
+            DrawCallback callback;
+        };
+
+        struct Model
+        {
+            RegionView* self;
+            uint32_t dirty;
+            T data;
+        };
+        static_assert(maxRegions <= sizeof(Model::dirty) * 8);
+
+        View view{};
+
+        Region regions[maxRegions]{};
+        size_t regionCount = 0;
+
+        // The model as of the last update, only touched with the model locked
+        T committed{};
+        size_t skippedUpdates = 0;
+
+        virtual void alloc() noexcept override
+        {
+            view.allocate();
+            UNUSED(view.allocateModel(ViewModelTypeLocking, sizeof(Model)));
+            UNUSED(view.setContext(this));
+
+            UNUSED(view.setDrawCallback([](::Canvas* canvas, void* m) -> void
+            {
+                auto* model = static_cast<Model*>(m);
+                const RegionView* self = model->self;
+
+                canvas_clear(canvas);
+                for (size_t i = 0; i < self->regionCount; i++)
+                {
+                    const Region& region = self->regions[i];
+                    Canvas c(canvas, region.x, region.y);
+                    region.callback(c, model->data, (model->dirty & (1u << i)) != 0);
+                }
+                model->dirty = 0;
+            }));
+            reset();
+        }
+
+        virtual void free() noexcept override
+        {
+            view.free();
+        }
+
+        virtual View getWidgetView() noexcept override
+        {
+            return UFZ::View(static_cast<::View*>(view));
+        }
+
+        virtual void reset() noexcept override
+        {
+            auto* model = static_cast<Model*>(view.getModel());
+            model->self = this;
+            model->dirty = UINT32_MAX;
+            model->data = T{};
+            committed = T{};
+            UNUSED(view.commitModel(true));
+        }
+    };
+
     class Widget final : public UWidget
     {
         UFZ_COMPONENT(Widget, widget);